@@ -0,0 +1,176 @@
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include "./Utils.hpp"
+#include <cstring>
+#include <future>
+
+// Structure that describes the state of an iterative algorithm at a given step.
+struct CheckpointState {
+	// Name of the algorithm that produced the state.
+	std::string algo;
+
+	// Fingerprint of the graph on which the state was computed.
+	uint64_t fingerprint = 0;
+
+	// Number of steps already done.
+	unsigned int steps = 0;
+
+	// Score vectors of the algorithm (e.g. PageRank Prestige, or authority and hub).
+	std::vector<std::vector<double>> vectors;
+
+	// Residual history of the algorithm, one vector for each convergence test.
+	std::vector<std::vector<double>> residuals;
+};
+
+// Class that periodically writes the state of an algorithm to a binary file, without blocking the computation.
+class Checkpointer {
+	public:
+		// Default constructor, the checkpointing is disabled.
+		Checkpointer() { };
+
+		// Checkpointer constructor.
+		Checkpointer(std::string path, unsigned int every) {
+			this->path = path;
+			this->every = every;
+		}
+
+		// Number of checkpoints written.
+		unsigned int written = 0;
+
+		// Public functions declaration
+
+		bool enabled();
+		bool due(unsigned int step);
+		void save_async(CheckpointState state);
+		void save(CheckpointState state);
+		void wait();
+		static bool load(const std::string& path, CheckpointState& state);
+
+	private:
+		std::string path;
+		unsigned int every = 0;
+
+		// Pending write of the previous checkpoint.
+		std::future<void> pending;
+
+		// Private functions declaration
+
+		static void write(const std::string& path, const CheckpointState& state);
+};
+
+// Magic number and version that identify a checkpoint file.
+const char CHECKPOINT_MAGIC[4] = {'P', 'R', 'C', 'K'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+// Function that returns whether the checkpointing is enabled.
+bool Checkpointer::enabled() {
+	return this->every > 0 && !this->path.empty();
+}
+
+// Function that returns whether a checkpoint should be taken at the given step.
+bool Checkpointer::due(unsigned int step) {
+	return this->enabled() && step % this->every == 0;
+}
+
+// Function that writes the state in a background thread; if the previous write is still running the checkpoint is skipped.
+void Checkpointer::save_async(CheckpointState state) {
+	if (this->pending.valid() && this->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	if (this->pending.valid()) this->pending.get();
+
+	this->pending = std::async(std::launch::async, [path = this->path, state = std::move(state)]() {
+		Checkpointer::write(path, state);
+	});
+	this->written++;
+}
+
+// Function that writes the state and waits for the write to complete.
+void Checkpointer::save(CheckpointState state) {
+	this->wait();
+	Checkpointer::write(this->path, state);
+	this->written++;
+}
+
+// Function that waits for the pending write, if any.
+void Checkpointer::wait() {
+	if (this->pending.valid()) this->pending.get();
+}
+
+// Function that serializes the state in a temporary file and then renames it, so that a killed run never leaves a truncated checkpoint.
+void Checkpointer::write(const std::string& path, const CheckpointState& state) {
+	std::string tmp_path = path + ".tmp";
+	std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw std::runtime_error("Could not open checkpoint file");
+
+	auto put = [&](const void* data, size_t size) { file.write((const char*)data, size); };
+	auto put_vectors = [&](const std::vector<std::vector<double>>& vectors) {
+		uint32_t count = vectors.size();
+		put(&count, sizeof(count));
+		for (const std::vector<double>& v : vectors) {
+			uint64_t length = v.size();
+			put(&length, sizeof(length));
+			put(v.data(), length * sizeof(double));
+		}
+	};
+
+	uint32_t algo_length = state.algo.size();
+	put(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	put(&CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION));
+	put(&state.fingerprint, sizeof(state.fingerprint));
+	put(&algo_length, sizeof(algo_length));
+	put(state.algo.data(), algo_length);
+	put(&state.steps, sizeof(state.steps));
+	put_vectors(state.vectors);
+	put_vectors(state.residuals);
+	file.close();
+
+	if (!file)
+		throw std::runtime_error("Could not write checkpoint file");
+
+	std::filesystem::rename(tmp_path, path);
+}
+
+// Function that reads a checkpoint file, it returns false if the file does not exist.
+bool Checkpointer::load(const std::string& path, CheckpointState& state) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	auto get = [&](void* data, size_t size) {
+		if (!file.read((char*)data, size))
+			throw std::runtime_error("Truncated checkpoint file");
+	};
+	auto get_vectors = [&](std::vector<std::vector<double>>& vectors) {
+		uint32_t count;
+		get(&count, sizeof(count));
+		vectors.resize(count);
+		for (std::vector<double>& v : vectors) {
+			uint64_t length;
+			get(&length, sizeof(length));
+			v.resize(length);
+			get(v.data(), length * sizeof(double));
+		}
+	};
+
+	char magic[4];
+	uint32_t version, algo_length;
+	get(magic, sizeof(magic));
+	get(&version, sizeof(version));
+	if (std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || version != CHECKPOINT_VERSION)
+		throw std::runtime_error("Invalid checkpoint file");
+
+	get(&state.fingerprint, sizeof(state.fingerprint));
+	get(&algo_length, sizeof(algo_length));
+	state.algo.resize(algo_length);
+	get(state.algo.data(), algo_length);
+	get(&state.steps, sizeof(state.steps));
+	get_vectors(state.vectors);
+	get_vectors(state.residuals);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef _COMPRESSED_H
+#define _COMPRESSED_H
+
+#include <sys/mman.h>
+#include "./Utils.hpp"
+
+// Function that writes a value as a LEB128 varint and returns the number of bytes used.
+inline unsigned int write_varint(unsigned char* out, unsigned int value) {
+	unsigned int len = 0;
+	while (value >= 0x80) {
+		out[len++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	out[len++] = (unsigned char)value;
+	return len;
+}
+
+// Function that returns the number of bytes needed to write a value as a LEB128 varint.
+inline unsigned int varint_length(unsigned int value) {
+	unsigned int len = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		len++;
+	}
+	return len;
+}
+
+// Function that reads a LEB128 varint and moves the stream pointer after it.
+inline unsigned int read_varint(const unsigned char*& p) {
+	unsigned int value = *p & 0x7F;
+
+	// fast path, on web graphs most of the gaps fit in a single byte
+	if (!(*p++ & 0x80)) return value;
+
+	unsigned int shift = 7;
+	unsigned char byte;
+	do {
+		byte = *p++;
+		value |= (unsigned int)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	return value;
+}
+
+// Functions that map a signed gap to an unsigned one and back (zigzag encoding).
+inline unsigned int zigzag(int value) { return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31); }
+inline int unzigzag(unsigned int value) { return (int)(value >> 1) ^ -(int)(value & 1); }
+
+// Structure that decodes a row one column at a time, where the visit cannot be a callback (e.g. an iterative depth first search).
+struct RowCursor {
+	const unsigned char* p = nullptr;
+	const unsigned char* end = nullptr;
+	unsigned int col = 0;
+	bool started = false;
+
+	// Public functions declaration
+
+	bool next();
+};
+
+// Function that moves the cursor to the next column of the row, it returns false at the end of the row.
+inline bool RowCursor::next() {
+	if (this->p == this->end) return false;
+	this->col = this->started ? this->col + read_varint(this->p) : this->col + unzigzag(read_varint(this->p));
+	this->started = true;
+	return true;
+}
+
+// Class that stores a sparse 0/1 matrix row by row, WebGraph style: each row is the sorted list of its
+// column indexes, the first one written as a zigzag gap from the row index and the others as gaps from
+// the previous column, all in LEB128 varints. Row i and column j refer to the node min_node + i and min_node + j.
+class CompressedMatrix {
+	public:
+		// Default constructor.
+		CompressedMatrix() { };
+
+		// Number of rows of the matrix (the whole node ID range, empty rows included).
+		unsigned int rows = 0;
+
+		// Number of non zero entries, i.e. the number of edges.
+		unsigned int nnz = 0;
+
+		// Byte offset of each row inside the stream, the last element is the size of the stream; 32 bits are enough for streams up to 4 GiB.
+		std::vector<uint32_t> row_offsets;
+
+		// Pointer to the gap encoded stream.
+		unsigned char* stream = nullptr;
+
+		// Size of the stream.
+		size_t bytes = 0;
+
+		// Public functions declaration
+
+		void build(nodes_pair* np_pointer, unsigned int edges, unsigned int min_node, unsigned int rows, bool by_destination);
+		template<typename Visit> void for_each_in_row(unsigned int row, Visit visit) const;
+		RowCursor cursor(unsigned int row) const;
+		void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+		double bytes_per_edge() const;
+		void freeMemory();
+};
+
+// Function that builds the matrix from the edges, with rows indexed by the source node (L) or by the destination node (L_t).
+void CompressedMatrix::build(nodes_pair* np_pointer, unsigned int edges, unsigned int min_node, unsigned int rows, bool by_destination) {
+	this->rows = rows;
+	this->nnz = edges;
+
+	auto row_of = [&](const nodes_pair& p) { return (by_destination ? p.second : p.first) - min_node; };
+	auto col_of = [&](const nodes_pair& p) { return (by_destination ? p.first : p.second) - min_node; };
+
+	// sorting the pairs by row and then by column, so that every gap inside a row is non negative
+	std::sort(np_pointer, np_pointer + edges, [&](const nodes_pair& pair1, const nodes_pair& pair2) {
+		unsigned int r1 = row_of(pair1), r2 = row_of(pair2);
+		return r1 < r2 || (r1 == r2 && col_of(pair1) < col_of(pair2));
+	});
+
+	// first pass: computing the encoded size of each row
+	this->row_offsets.assign(rows + 1, 0);
+	for (unsigned int i = 0; i < edges; i++) {
+		unsigned int row = row_of(np_pointer[i]);
+		unsigned int col = col_of(np_pointer[i]);
+		if (i == 0 || row_of(np_pointer[i - 1]) != row)
+			this->row_offsets[row + 1] += varint_length(zigzag((int)col - (int)row));
+		else
+			this->row_offsets[row + 1] += varint_length(col - col_of(np_pointer[i - 1]));
+	}
+	size_t total = 0;
+	for (unsigned int r = 0; r < rows; r++) {
+		total += this->row_offsets[r + 1];
+		if (total > UINT32_MAX)
+			throw std::runtime_error("The compressed matrix exceeds 4 GiB\n");
+		this->row_offsets[r + 1] = total;
+	}
+	this->bytes = total;
+
+	// allocating the right amount of memory
+	this->stream = (unsigned char*)mmap(NULL, std::max<size_t>(this->bytes, 1), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
+	if (this->stream == MAP_FAILED)
+		throw std::runtime_error("Mapping stream Failed\n");
+
+	// second pass: writing the gaps
+	size_t pos = 0;
+	for (unsigned int i = 0; i < edges; i++) {
+		unsigned int row = row_of(np_pointer[i]);
+		unsigned int col = col_of(np_pointer[i]);
+		if (i == 0 || row_of(np_pointer[i - 1]) != row)
+			pos += write_varint(this->stream + pos, zigzag((int)col - (int)row));
+		else
+			pos += write_varint(this->stream + pos, col - col_of(np_pointer[i - 1]));
+	}
+}
+
+// Function that decodes a row and calls visit on each of its column indexes.
+template<typename Visit>
+inline void CompressedMatrix::for_each_in_row(unsigned int row, Visit visit) const {
+	const unsigned char* p = this->stream + this->row_offsets[row];
+	const unsigned char* end = this->stream + this->row_offsets[row + 1];
+	if (p == end) return;
+
+	unsigned int col = row + unzigzag(read_varint(p));
+	visit(col);
+	while (p < end) {
+		col += read_varint(p);
+		visit(col);
+	}
+}
+
+// Function that returns a cursor on the columns of a row.
+inline RowCursor CompressedMatrix::cursor(unsigned int row) const {
+	RowCursor cursor;
+	cursor.p = this->stream + this->row_offsets[row];
+	cursor.end = this->stream + this->row_offsets[row + 1];
+	// the first column is a gap from the row index
+	cursor.col = row;
+	return cursor;
+}
+
+// Function that computes y = M * x, decoding the rows on the fly.
+void CompressedMatrix::multiply(const std::vector<double>& x, std::vector<double>& y) const {
+	for (unsigned int row = 0; row < this->rows; row++) {
+		double sum = 0.;
+		this->for_each_in_row(row, [&](unsigned int col) { sum += x[col]; });
+		y[row] = sum;
+	}
+}
+
+// Function that returns the average number of bytes used to store an edge, the row offsets included.
+double CompressedMatrix::bytes_per_edge() const {
+	return this->nnz == 0 ? 0. : (double)(this->bytes + this->row_offsets.size() * sizeof(uint32_t)) / this->nnz;
+}
+
+// Function that frees the permanent memory regarding the stream.
+void CompressedMatrix::freeMemory() {
+	if (munmap(this->stream, std::max<size_t>(this->bytes, 1)) != 0)
+		throw std::runtime_error("Free memory failed\n");
+}
+
+// Function that sets 1/Oi for each node of the edge list (0 for the dangling ones) and the indices of the dangling nodes,
+// the vectors kept next to a CompressedMatrix in place of the values of the transition matrix.
+void set_inv_out_degree(const nodes_pair* np_pointer, unsigned int edges, unsigned int min_node, unsigned int rows,
+						std::vector<double>& inv_out_degree, std::vector<unsigned int>& dangling_nodes) {
+	std::vector<unsigned int> cardinality(rows, 0);
+
+	for (unsigned int i = 0; i < edges; i++)
+		cardinality[np_pointer[i].first - min_node]++;
+
+	inv_out_degree.assign(rows, 0.);
+	dangling_nodes.clear();
+	for (unsigned int i = 0; i < rows; i++) {
+		if (cardinality[i] == 0)
+			dangling_nodes.push_back(i);
+		else
+			inv_out_degree[i] = 1. / cardinality[i];
+	}
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef _FUSED_H
+#define _FUSED_H
+
+#include "Graph.hpp"
+#include "Compressed.hpp"
+#include <cmath>
+
+// Class that computes InDegree, PageRank and HITS together on a single copy of the graph.
+// The in-link matrix (row j holds the sources of the in-links of node j) is the T matrix of PageRank and the L_t matrix of HITS,
+// so each step streams it once: the PageRank and authority sums gather from the same decoded edge, the hub sums are scattered
+// from it (h_k+1[i] += a_k[j] for each link i -> j) and the InDegree counts are the row lengths of the first sweep.
+// An algorithm that converges stops being updated, the sweeps go on while the other one runs.
+class FusedScan {
+	public:
+		// FusedScan constructor.
+		FusedScan(std::vector<unsigned int> top_k, std::string ds_path, double t_prob) : t_prob(t_prob) {
+			this->top_k = top_k;
+			this->graph = Graph(ds_path);
+
+			this->In_Deg_Prestige.assign(this->graph.id_space(), 0.);
+			this->PR_Prestige.assign(this->graph.id_space(), 1. / this->graph.nodes);
+			this->HITS_authority.assign(this->graph.id_space(), 1.);
+			this->HITS_hub.assign(this->graph.id_space(), 1.);
+
+			set_inv_out_degree(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), this->inv_out_degree, this->dangling_nodes);
+
+			// encoding the in-links of each node as gaps, then freeing the edges
+			this->in_matrix.build(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), true);
+			this->graph.freeMemory();
+		}
+
+		// Vector that indicates the k value for which the top-k ranking is computed.
+		std::vector<unsigned int> top_k;
+
+		// Score vectors, indexed by node ID - min_node.
+		std::vector<double> In_Deg_Prestige;
+		std::vector<double> PR_Prestige;
+		std::vector<double> HITS_authority;
+		std::vector<double> HITS_hub;
+
+		// Top-k results of each algorithm.
+		top_k_results IN_topk;
+		top_k_results PR_topk;
+		top_k_results authority_topk;
+		top_k_results hub_topk;
+
+		// Number of steps of PageRank and HITS, and number of sweeps over the in-link matrix.
+		unsigned int PR_steps = 0;
+		unsigned int HITS_steps = 0;
+		unsigned int sweeps = 0;
+
+		// Residual histories, as in PageRank and HITS.
+		std::vector<double> PR_residuals;
+		std::vector<double> authority_residuals;
+		std::vector<double> hub_residuals;
+
+		// Time from the start of the computation to the end of the first sweep (InDegree) and to the convergence of PageRank and HITS.
+		Duration IN_elapsed;
+		Duration PR_elapsed;
+		Duration HITS_elapsed;
+
+		// Total elapsed time.
+		Duration elapsed;
+
+		// Public functions declaration
+
+		void compute();
+		void get_topk_results();
+		std::string get_stats();
+		std::vector<std::pair<unsigned int, double>> get_in_degree_scores();
+		std::vector<std::pair<unsigned int, double>> get_pagerank_scores();
+		std::vector<std::pair<unsigned int, double>> get_authority_scores();
+		std::vector<std::pair<unsigned int, double>> get_hub_scores();
+		void free_matrix_memory();
+
+	private:
+		Graph graph;
+		const double t_prob;
+
+		// Vector that memorizes 1/Oi for each node, 0 for the dangling ones.
+		std::vector<double> inv_out_degree;
+
+		// Vector that memorizes the index of dangling nodes.
+		std::vector<unsigned int> dangling_nodes;
+
+		// Gap encoded in-link matrix shared by the three algorithms.
+		CompressedMatrix in_matrix;
+
+		// Private functions declaration
+
+		template<bool PR, bool HITS> void sweep(const std::vector<double>& contribution, double dangling_Pk, std::vector<double>& next_PR,
+												std::vector<double>& next_authority, std::vector<double>& next_hub, bool count_in_links);
+		double distance(const std::vector<double>& v1, const std::vector<double>& v2);
+};
+
+// Function that streams the in-link matrix once, updating the algorithms that are still running.
+template<bool PR, bool HITS>
+void FusedScan::sweep(const std::vector<double>& contribution, double dangling_Pk, std::vector<double>& next_PR,
+					  std::vector<double>& next_authority, std::vector<double>& next_hub, bool count_in_links) {
+	const double norm = 1. / (this->graph.nodes - 1);
+
+	for (unsigned int row = 0; row < this->in_matrix.rows; row++) {
+		double pr_sum = 0., authority_sum = 0.;
+		const double authority = HITS ? this->HITS_authority[row] : 0.;
+		unsigned int in_links = 0;
+
+		this->in_matrix.for_each_in_row(row, [&](unsigned int col) {
+			if constexpr (PR) pr_sum += contribution[col];
+			if constexpr (HITS) {
+				authority_sum += this->HITS_hub[col];
+				next_hub[col] += authority;
+			}
+			in_links++;
+		});
+
+		if constexpr (PR) next_PR[row] = ((dangling_Pk + pr_sum) * this->t_prob) + (1 - this->t_prob) / this->graph.nodes;
+		if constexpr (HITS) next_authority[row] = authority_sum;
+		if (count_in_links) this->In_Deg_Prestige[row] = in_links * norm;
+	}
+}
+
+// Function that returns the L2 distance between two vectors.
+double FusedScan::distance(const std::vector<double>& v1, const std::vector<double>& v2) {
+	double distance = 0.;
+	for (unsigned int i = 0; i < v1.size(); i++)
+		distance += std::pow(std::abs(v1[i] - v2[i]), 2.);
+	return std::sqrt(distance);
+}
+
+// Function that computes the three algorithms, sweeping the in-link matrix until PageRank and HITS have both converged.
+void FusedScan::compute() {
+	std::vector<double> next_PR(this->PR_Prestige.size(), 0.);
+	std::vector<double> next_authority(this->HITS_authority.size(), 0.);
+	std::vector<double> next_hub(this->HITS_hub.size(), 0.);
+
+	// P_k[i] / Oi, computed once per node so that each edge costs a single random access
+	std::vector<double> contribution(this->PR_Prestige.size(), 0.);
+
+	const double threshold = std::pow(10, -10);
+	bool pr_running = true, hits_running = true;
+
+	auto start = now();
+
+	while (pr_running || hits_running) {
+		double dangling_Pk = 0.;
+
+		if (pr_running) {
+			// computing the PageRank of dangling nodes
+			for (unsigned int dan : this->dangling_nodes)
+				dangling_Pk += this->PR_Prestige[dan] * (1. / this->graph.nodes);
+
+			for (unsigned int i = 0; i < contribution.size(); i++)
+				contribution[i] = this->PR_Prestige[i] * this->inv_out_degree[i];
+		}
+
+		if (hits_running)
+			std::fill(next_hub.begin(), next_hub.end(), 0.);
+
+		bool first = this->sweeps == 0;
+		if (pr_running && hits_running)
+			this->sweep<true, true>(contribution, dangling_Pk, next_PR, next_authority, next_hub, first);
+		else if (pr_running)
+			this->sweep<true, false>(contribution, dangling_Pk, next_PR, next_authority, next_hub, first);
+		else
+			this->sweep<false, true>(contribution, dangling_Pk, next_PR, next_authority, next_hub, first);
+		this->sweeps++;
+
+		if (first) this->IN_elapsed = now() - start;
+
+		if (pr_running) {
+			this->PR_steps++;
+			this->PR_residuals.push_back(this->distance(this->PR_Prestige, next_PR));
+			std::swap(this->PR_Prestige, next_PR);
+
+			pr_running = this->PR_residuals.back() > threshold;
+			if (!pr_running) this->PR_elapsed = now() - start;
+		}
+
+		if (hits_running) {
+			this->HITS_steps++;
+
+			// normalizing in order to obtain a probability distribution
+			double sum_a = std::accumulate(next_authority.begin(), next_authority.end(), 0.);
+			double sum_h = std::accumulate(next_hub.begin(), next_hub.end(), 0.);
+			for (unsigned int i = 0; i < next_authority.size(); i++) {
+				next_authority[i] /= sum_a;
+				next_hub[i] /= sum_h;
+			}
+
+			this->authority_residuals.push_back(this->distance(this->HITS_authority, next_authority));
+			this->hub_residuals.push_back(this->distance(this->HITS_hub, next_hub));
+			std::swap(this->HITS_authority, next_authority);
+			std::swap(this->HITS_hub, next_hub);
+
+			hits_running = this->authority_residuals.back() > threshold && this->hub_residuals.back() > threshold;
+			if (!hits_running) this->HITS_elapsed = now() - start;
+		}
+	}
+
+	this->elapsed = now() - start;
+}
+
+// Function that computes the top-k nodes of each algorithm.
+void FusedScan::get_topk_results() {
+	select_topk(this->get_in_degree_scores(), this->top_k, this->IN_topk);
+	this->graph.get_algo_topk_results(this->PR_Prestige, this->top_k, this->PR_topk);
+	this->graph.get_algo_topk_results(this->HITS_authority, this->top_k, this->authority_topk);
+	this->graph.get_algo_topk_results(this->HITS_hub, this->top_k, this->hub_topk);
+}
+
+// Function that returns the (node ID, InDegree Prestige) pairs of the nodes with at least one in-link.
+std::vector<std::pair<unsigned int, double>> FusedScan::get_in_degree_scores() {
+	std::vector<std::pair<unsigned int, double>> pairs;
+	for (unsigned int i = 0; i < this->In_Deg_Prestige.size(); i++)
+		if (this->In_Deg_Prestige[i] > 0.) pairs.push_back(std::make_pair(i + this->graph.min_node, this->In_Deg_Prestige[i]));
+	return pairs;
+}
+
+// Function that returns the (node ID, PageRank Prestige) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> FusedScan::get_pagerank_scores() {
+	return this->graph.get_scores(this->PR_Prestige);
+}
+
+// Function that returns the (node ID, authority score) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> FusedScan::get_authority_scores() {
+	return this->graph.get_scores(this->HITS_authority);
+}
+
+// Function that returns the (node ID, hub score) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> FusedScan::get_hub_scores() {
+	return this->graph.get_scores(this->HITS_hub);
+}
+
+// Function that returns the elapsed times, the steps of each algorithm and the traffic over the in-link matrix.
+std::string FusedScan::get_stats() {
+	std::ostringstream stats;
+	stats << "Elapsed: " << this->elapsed.count() << " ms \t Sweeps: " << this->sweeps
+		  << " \t Streamed: " << (double)this->in_matrix.bytes * this->sweeps / (1 << 20) << " MB" << std::endl;
+	stats << "InDegree \t Elapsed: " << this->IN_elapsed.count() << " ms" << std::endl;
+	stats << "PageRank \t Elapsed: " << this->PR_elapsed.count() << " ms \t Steps: " << this->PR_steps << std::endl;
+	stats << "HITS \t\t Elapsed: " << this->HITS_elapsed.count() << " ms \t Steps: " << this->HITS_steps << std::endl;
+	return stats.str();
+}
+
+// Function that frees the permanent memory regarding the in-link matrix.
+void FusedScan::free_matrix_memory() {
+	this->in_matrix.freeMemory();
+}
+
+#endif
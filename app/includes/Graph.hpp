@@ -4,6 +4,9 @@
 #include <sys/mman.h>
 #include <limits.h>
 #include "./Utils.hpp"
+#include "./Reporter.hpp"
+#include "./Ingest.hpp"
+#include <atomic>
 #include <sstream>
 #include <cmath>
 
@@ -19,6 +22,7 @@ class Graph {
 			this->ds_path = ds_path;
 			this->set_nodes_edges(ds_path);
 			this->allocate_memory();
+			this->set_fingerprint();
 		}
         
 		int nodes;
@@ -26,6 +30,9 @@ class Graph {
 		int min_node = INT32_MAX;
 		int max_node = 0;
 
+		// Fingerprint of the dataset file and of its shape, used to validate checkpoints.
+		uint64_t fingerprint = 0;
+
 		// Pointer to nodes_pair to start memorizing edges.
 		nodes_pair* np_pointer; 
 
@@ -34,124 +41,109 @@ class Graph {
 
 		void freeMemory();
 
+		unsigned int id_space();
+
         void get_algo_topk_results(std::unordered_map<unsigned int, double> iter, std::vector<unsigned int>& top_k, top_k_results& algo_topk);
 
+        void get_algo_topk_results(const std::vector<double>& scores, std::vector<unsigned int>& top_k, top_k_results& algo_topk);
+
         void print_algo_topk_results(top_k_results& algo_topk, std::string& algo_str);
 
+        std::vector<std::pair<unsigned int, double>> get_scores(const std::vector<double>& scores);
+
 	private:
 		std::string ds_path;
-		std::vector<int> parseLine(const std::string& line);
 
 		// Private functions declaration
 
 		void set_nodes_edges(const std::string& ds_path);
 		void allocate_memory();
-		void updateMinMaxNodes(const std::vector<int>& pair);
+		void set_fingerprint();
 };
 
 // Function that reads the file and gets the number of nodes and edges from the description.
 void Graph::set_nodes_edges(const std::string& ds_path) { 
-	std::ifstream file = readDataset(this->ds_path);
-	std::string line;
-    for (int i = 0; i < 2; ++i) std::getline(file, line);
-	
-	// reading the third line of the description
-	std::getline(file, line);
-	file.close();
-
-	std::istringstream line_stream(line);
-    std::string str;
-	
-	// extracting the number of nodes and edges
-	while (line_stream >> str) {
-        if (str == "Nodes:") 
-            line_stream >> this->nodes;
-        else if (str == "Edges:")
-            line_stream >> this->edges;
-    }
+	// the header is read from the decompressed text if the dataset is compressed
+	read_snap_header(read_file_head(ds_path), this->nodes, this->edges);
 }
 
-// Function that parses the string line.
-std::vector<int> Graph::parseLine(const std::string& line) {
-    std::istringstream line_stream(line);
-    std::string str;
-    std::vector<int> pair;
-    
-    while (std::getline(line_stream, str, '\t'))
-        pair.push_back(std::stoi(str));
-    
-    return pair;
-}
+// Function that allocates permanent memory and reads the edges, parsing the dataset with one thread for each core.
+void Graph::allocate_memory() {
 
-// Function that updates the minimum and maximum node given a pair of nodes.
-void Graph::updateMinMaxNodes(const std::vector<int>& pair) {
-    if (pair[0] < this->min_node)
-        this->min_node = pair[0];
-    if (pair[0] > this->max_node)
-        this->max_node = pair[0];
-    
-    if (pair[1] < this->min_node)
-        this->min_node = pair[1];
-    if (pair[1] > this->max_node)
-        this->max_node = pair[1];
+	// allocating the right amount of memory
+	this->np_pointer = (nodes_pair*)mmap(NULL, this->edges * sizeof(nodes_pair), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
+	if (this->np_pointer == MAP_FAILED)
+		throw std::runtime_error("Mapping np_pointer Failed\n");
+
+	// each worker collects its edges in a small buffer, which is copied in a block of np_pointer reserved with an atomic counter
+	unsigned int workers = default_workers();
+	std::vector<std::vector<nodes_pair>> buffers(workers);
+	std::vector<int> min_nodes(workers, INT32_MAX), max_nodes(workers, 0);
+	std::atomic<size_t> next_edge(0);
+
+	auto flush = [&](unsigned int w) {
+		size_t begin = next_edge.fetch_add(buffers[w].size());
+		if (begin + buffers[w].size() <= (size_t)this->edges)
+			std::copy(buffers[w].begin(), buffers[w].end(), this->np_pointer + begin);
+		buffers[w].clear();
+	};
+
+	for_each_edge(this->ds_path, workers, [&](unsigned int w, unsigned int from, unsigned int to) {
+		buffers[w].push_back(nodes_pair(from, to));
+		min_nodes[w] = std::min({min_nodes[w], (int)from, (int)to});
+		max_nodes[w] = std::max({max_nodes[w], (int)from, (int)to});
+		if (buffers[w].size() == 4096) flush(w);
+	});
+	for (unsigned int w = 0; w < workers; w++) flush(w);
+
+	if (next_edge != (size_t)this->edges)
+		throw std::runtime_error("The number of edges of " + this->ds_path + " does not match its header\n");
+
+	this->min_node = *std::min_element(min_nodes.begin(), min_nodes.end());
+	this->max_node = *std::max_element(max_nodes.begin(), max_nodes.end());
 }
 
-// Function that allocates permanent memory.
-void Graph::allocate_memory() {
-    
-	// allocating the right amount of memory
-    this->np_pointer = (nodes_pair*)mmap(NULL, this->edges * sizeof(nodes_pair), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
-    if (this->np_pointer == MAP_FAILED)
-        throw std::runtime_error("Mapping np_pointer Failed\n");
-    
-	// reading the dataset
-    std::ifstream file = readDataset(this->ds_path);
-    std::string line;
-    int i = 0;
-    
-	// for each line until we read the entire file
-    while (std::getline(file, line)) {
-
-		// excluding the description part
-        if (line[0] != '#') {
-            std::vector<int> pair = this->parseLine(line);
-            this->updateMinMaxNodes(pair);
-            this->np_pointer[i] = nodes_pair(pair[0], pair[1]);
-            i++;
-        }
-    }
-	
-    file.close();
+// Function that combines the file fingerprint with the number of nodes and edges and with the node ID range.
+void Graph::set_fingerprint() {
+	int shape[4] = {this->nodes, this->edges, this->min_node, this->max_node};
+	this->fingerprint = fnv1a(shape, sizeof(shape), file_fingerprint(this->ds_path));
 }
 
 // Function that frees the permanent memory regarding the graph.
 void Graph::freeMemory() {
-	if (munmap(this->np_pointer, this->edges) != 0)
+	if (munmap(this->np_pointer, this->edges * sizeof(nodes_pair)) != 0)
     	throw std::runtime_error("Free memory failed\n");
 }
 
+// Function that returns the size of the node ID range, that is the length of the dense score vectors.
+unsigned int Graph::id_space() {
+	return this->max_node - this->min_node + 1;
+}
+
 // Function that obtains the top_k nodes of a given algorithm.
 void Graph::get_algo_topk_results(std::unordered_map<unsigned int, double> iter, std::vector<unsigned int>& topk, top_k_results& algo_topk) {
 
-    std::vector<std::pair<unsigned int, double>> pairs(iter.begin(), iter.end());
-	std::sort(pairs.begin(), pairs.end(), compareBySecondDecreasing);
+	select_topk(std::vector<std::pair<unsigned int, double>>(iter.begin(), iter.end()), topk, algo_topk);
+}
+
+// Function that obtains the top_k nodes of a given algorithm from a dense score vector indexed by node ID - min_node.
+void Graph::get_algo_topk_results(const std::vector<double>& scores, std::vector<unsigned int>& topk, top_k_results& algo_topk) {
+
+	select_topk(this->get_scores(scores), topk, algo_topk);
+}
 
-	for(int k : topk) {
-		std::vector<std::pair<unsigned int, double>> final_top_k(pairs.begin(), pairs.begin() + k); 
-		algo_topk[k] = final_top_k;
-	}
+// Function that returns the (node ID, score) pairs of a dense score vector indexed by node ID - min_node.
+std::vector<std::pair<unsigned int, double>> Graph::get_scores(const std::vector<double>& scores) {
+	std::vector<std::pair<unsigned int, double>> pairs(scores.size());
+	for (unsigned int i = 0; i < scores.size(); i++) pairs[i] = std::make_pair(i + this->min_node, scores[i]);
+	return pairs;
 }
 
 // Function that prints the top_k nodes of a given algorithm.
 void Graph::print_algo_topk_results(top_k_results& algo_topk, std::string& algo_str) {
-	for (auto p : algo_topk){
-		std::cout << "Top " << p.first << std::endl;
-		int i = 1;
-		for (auto node : p.second) {
-			std::cout << i << ") Node ID: " << node.first << " - " + algo_str + " value: " << node.second << std::endl;
-			i++;
-		}
-	}
+	// formatting everything in memory and writing it with a single call instead of flushing each line
+	write_all(stdout, format_topk(algo_topk, algo_str));
+	std::fflush(stdout);
 }
 
 #endif
\ No newline at end of file
@@ -1,4 +1,8 @@
 #include "Graph.hpp"
+#include "Compressed.hpp"
+#include "Checkpoint.hpp"
+#include "Partition.hpp"
+#include "Lanczos.hpp"
 
 // This class provides the implementation of the HITS algorithm.
 class HITS {
@@ -14,11 +18,11 @@ class HITS {
 		// Vector that indicates the k value for which the top-k ranking is computed.
 		std::vector<unsigned int> top_k;
 
-		// Map: NodeID <-> authority score at time k.
-		std::unordered_map<unsigned int, double> HITS_authority;
+		// Vector: NodeID - min_node <-> authority score at time k.
+		std::vector<double> HITS_authority;
 
-		// Map: NodeID <-> hub score at time k.
-		std::unordered_map<unsigned int, double> HITS_hub;
+		// Vector: NodeID - min_node <-> hub score at time k.
+		std::vector<double> HITS_hub;
 
 		// Vector containing the final top-k authority scores.
 		top_k_results authority_topk;
@@ -27,11 +31,25 @@ class HITS {
 		top_k_results hub_topk;
 		
 		// Number of steps for convergence.
-		int steps = 0;
+		unsigned int steps = 0;
+
+		// Residual histories, the L2 distance between two consecutive authority and hub vectors.
+		std::vector<double> authority_residuals;
+		std::vector<double> hub_residuals;
+
+		// Dominant singular values of L computed by the Lanczos solver.
+		std::vector<double> singular_values;
+
+		// Dominant authority (right) and hub (left) singular vectors computed by the Lanczos solver, when more than one is requested.
+		std::vector<std::vector<double>> singular_authority;
+		std::vector<std::vector<double>> singular_hub;
 
 		// Elapsed time for computation.
 		Duration elapsed;
 
+		// Communication of the partitioned run, no workers if the computation ran in this process.
+		PartitionTraffic traffic;
+
 		// Public functions declaration.
 		
 		void compute_L();
@@ -39,6 +57,8 @@ class HITS {
 		void create_L_and_L_t();
 		void initialize_ak_hk();
 		void compute();
+		void compute_partitioned(unsigned int workers);
+		void compute_lanczos(unsigned int rank, unsigned int subspace);
 		void get_topk_authority();
 		void get_topk_hub();
 		void print_authority();
@@ -46,90 +66,58 @@ class HITS {
 		void print_topk_authority();
 		void print_topk_hub();
 		void print_stats();
+		std::string get_stats();
+		std::string get_singular_values_str();
+		std::vector<std::pair<unsigned int, double>> get_authority_scores();
+		std::vector<std::pair<unsigned int, double>> get_hub_scores();
 		void free_matrices_memory();
+		void enable_checkpoint(std::string path, unsigned int every);
+		bool resume(std::string path);
+		bool seed(std::string path);
 
 	private:
 		// Stores the graph for which the HITS is computed.
 		Graph graph;
 
-		// Pointer to the destination nodes of the adjacency matrix L.
-    	unsigned int* L_ptr;
-
-		// Vector of row pointer pairs for the adjacency matrix L.
-		std::vector<std::pair<unsigned int, unsigned int>> row_ptr_enempty_L;
+		// Gap encoded adjacency matrix L, row i holds the destination nodes of the out-links of node i.
+		CompressedMatrix L_matrix;
 
-		// Pointer to the destination nodes of the transpose od the adjacency matrix L, L_t.
-    	unsigned int* L_t_ptr;
+		// Gap encoded transpose of the adjacency matrix L, L_t.
+		CompressedMatrix L_t_matrix;
 
-		// Vector of row pointer pairs for the adjacency matrix L_t.
-		std::vector<std::pair<unsigned int, unsigned int>> row_ptr_enempty_L_t;
+		// Periodic writer of the HITS state.
+		Checkpointer checkpointer;
 		
 		std::string autority_str = "Authority"; 
 		std::string hub_str = "Hub"; 
 
 		// Private functions declaration
 
-		bool converge(std::unordered_map<unsigned int, double> &temp_a, std::unordered_map<unsigned int,double> &temp_h);
-		void normalize(std::unordered_map<unsigned int, double> &ak, std::unordered_map<unsigned int, double> &hk);
+		bool converge(std::vector<double> &temp_a, std::vector<double> &temp_h);
+		void normalize(std::vector<double> &ak, std::vector<double> &hk);
+		CheckpointState get_state();
+		bool load_state(std::string path, bool validate);
 };
 
 // Function that computes the adjacency matrix L.
 void HITS::compute_L(){
 	
-	// allocating the right amount of space in the permanent memory to save the edges of graph as a set of pairs
-	this->L_ptr = (unsigned int*)mmap(NULL, this->graph.edges * sizeof(unsigned int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
-
-	// checking the allocation
-	if (L_ptr == MAP_FAILED)
-		throw std::runtime_error("Mapping failed\n");
-	
-	// computing L and the adjacency matrix
-	for (unsigned int i = 0; i < this->graph.edges; i++){
-		if(i == 0 || this->graph.np_pointer[i - 1].first != this->graph.np_pointer[i].first)
-
-			// adding the row pointer and the non empty row pointer in the vector of pow pointers pairs
-			this->row_ptr_enempty_L.push_back(std::make_pair(i, this->graph.np_pointer[i].first - this->graph.min_node));
-
-		this->L_ptr[i] = this->graph.np_pointer[i].second;
-	}
-
-	// notifying the conclusion 
-	this->row_ptr_enempty_L.push_back(std::make_pair(this->graph.edges, this->graph.edges)); 
+	// encoding the out-links of each node as gaps
+	this->L_matrix.build(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), false);
 }
 
 // Function that computes the transpose matrix of the adjacency matrix L, L_t.
 void HITS::compute_L_t(){
 
-	// allocating the right amount of space in the permanent memory to save the edges of graph as a set of pairs
-	this->L_t_ptr = (unsigned int*)mmap(NULL, this->graph.edges * sizeof(unsigned int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
-	
-	// checking the allocation
-	if (L_t_ptr == MAP_FAILED)
-		throw std::runtime_error("Mapping failed\n");
-		
-	// computing L_t and the transpose of the adjacency matrix
-	for (unsigned int i = 0; i < this->graph.edges; i++){
-		if(i == 0 || this->graph.np_pointer[i - 1].second != this->graph.np_pointer[i].second)
-
-			// adding the row pointer and the non empty row pointer in the vector of pow pointers pairs
-			this->row_ptr_enempty_L_t.push_back(std::make_pair(i, this->graph.np_pointer[i].second - this->graph.min_node));
-
-		this->L_t_ptr[i] = this->graph.np_pointer[i].first;
-	}
-
-	// notifying the conclusion 
-	this->row_ptr_enempty_L_t.push_back(std::make_pair(this->graph.edges, this->graph.edges));
+	// encoding the in-links of each node as gaps
+	this->L_t_matrix.build(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), true);
 }
 
 // Function that creates L and L_t and that performs the two matrix multiplications.
 void HITS::create_L_and_L_t(){
 
-	// sorting the pairs w.r.t. the source node
-	std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.edges, compareByFirstIncreasing);
+	// the pairs are sorted w.r.t. the source node and then w.r.t. the destination node while encoding
 	this->compute_L();
-
-	// sorting again w.r.t. the destination node 
-	std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.edges, compareBySecondIncreasing);
 	this->compute_L_t();
 
 	// freeing the memory 
@@ -138,66 +126,193 @@ void HITS::create_L_and_L_t(){
 
 // Function that initializes authority and hub vectors.
 void HITS::initialize_ak_hk(){
-	for (unsigned int i = 0; i < this->graph.nodes; i++) this->HITS_authority[i] = 1.;
-	for (unsigned int i = 0; i < this->graph.nodes; i++) this->HITS_hub[i] = 1.;
+	this->HITS_authority.assign(this->graph.id_space(), 1.);
+	this->HITS_hub.assign(this->graph.id_space(), 1.);
 }
 
 // Function that computes autority and hub vectors.
 void HITS::compute(){
-    this->steps = 0;
-
 	// authority scores at time k+1
-    std::unordered_map<unsigned int, double> temp_HITS_authority;
-	for (unsigned int i = 0; i < this->graph.nodes; i++) temp_HITS_authority[i] = 1.;
+    std::vector<double> temp_HITS_authority(this->HITS_authority.size(), 0.);
 
 	// hub scores at time k+1
-	std::unordered_map<unsigned int, double> temp_HITS_hub;
-	for (unsigned int i = 0; i < this->graph.nodes; i++) temp_HITS_hub[i] = 1.;
+	std::vector<double> temp_HITS_hub(this->HITS_hub.size(), 0.);
 
 	auto start = now();
+	bool running;
 
 	// repeat until convergence
     do {
         this->steps++;
 
 		// hub score
-    	// h_k+1 = L * a_k
+    	// h_k+1 = L * a_k, the rows of L are decoded on the fly
+		this->L_matrix.multiply(this->HITS_authority, temp_HITS_hub);
 
-        unsigned int row_ptr = 0;
-        unsigned int next_row_ptr = this->row_ptr_enempty_L[row_ptr + 1].first;
-        for (unsigned int i = 0; i < this->graph.edges; i++){
+        // authority score
+		// a_k+1 = L^t * h_k, the rows of L_t are decoded on the fly
+		this->L_t_matrix.multiply(this->HITS_hub, temp_HITS_authority);
 
-			// control if we can update the same node until change matrix row change
-            if (i == next_row_ptr){
-                row_ptr++;
-                next_row_ptr = this->row_ptr_enempty_L[row_ptr + 1].first;
-            }
-			temp_HITS_hub[this->row_ptr_enempty_L[row_ptr].second] += 1 * this->HITS_authority[this->L_ptr[i]];
-        }
+        this->normalize(temp_HITS_authority, temp_HITS_hub);		
+		running = this->converge(temp_HITS_authority, temp_HITS_hub);
 
-        // authority score
-		// a_k+1 = L^t * h_k
-
-        row_ptr = 0;
-        next_row_ptr = this->row_ptr_enempty_L_t[row_ptr + 1].first;
-        for (unsigned int i = 0; i < this->graph.edges; i++){
-
-			// control if we can update the same node until change matrix row change
-            if (i == next_row_ptr){
-                row_ptr++;
-                next_row_ptr = this->row_ptr_enempty_L_t[row_ptr + 1].first;
-            }
-			temp_HITS_authority[this->row_ptr_enempty_L_t[row_ptr].second] += 1 * this->HITS_hub[this->L_t_ptr[i]];
+		// snapshotting the state, the file is written by a background thread
+		if (running && this->checkpointer.due(this->steps))
+			this->checkpointer.save_async(this->get_state());
+    } while (running);
+	
+	this->elapsed = now() - start;
+
+	// the final state is always saved, so that it can seed new runs
+	if (this->checkpointer.enabled())
+		this->checkpointer.save(this->get_state());
+}
+
+// Commands of the partitioned HITS.
+const unsigned int HITS_TRAFFIC = 1;
+const unsigned int HITS_STEP = 2;
+const unsigned int HITS_NORMALIZE = 3;
+
+// Function that computes autority and hub vectors with a group of worker processes, each one owning the same contiguous slice of
+// the rows of L (hub) and of L_t (authority). The vectors live in shared memory: a worker writes only its slice and reads the
+// entries of the other slices it needs, while the coordinator reduces the normalization sums and the residuals of each step.
+void HITS::compute_partitioned(unsigned int workers) {
+	const unsigned int size = this->HITS_authority.size();
+	std::vector<unsigned int> bounds = partition_rows({&this->L_matrix, &this->L_t_matrix}, workers);
+
+	double* authority = shared_array(size);
+	double* hub = shared_array(size);
+	double* next_authority = shared_array(size);
+	double* next_hub = shared_array(size);
+	std::copy(this->HITS_authority.begin(), this->HITS_authority.end(), authority);
+	std::copy(this->HITS_hub.begin(), this->HITS_hub.end(), hub);
+
+	auto start = now();
+
+	WorkerGroup group(workers, [&](unsigned int w, const PartitionMessage& message) {
+		PartitionMessage reply;
+		reply.command = message.command;
+		const unsigned int lo = bounds[w], hi = bounds[w + 1];
+
+		if (message.command == HITS_TRAFFIC) {
+			slice_traffic(this->L_matrix, lo, hi, reply.values[0], reply.values[1]);
+			slice_traffic(this->L_t_matrix, lo, hi, reply.values[0], reply.values[1]);
 		}
+		else if (message.command == HITS_STEP) {
+			// h_k+1 = L * a_k and a_k+1 = L^t * h_k on the rows of the slice, with their partial sums
+			for (unsigned int row = lo; row < hi; row++) {
+				double sum_h = 0., sum_a = 0.;
+				this->L_matrix.for_each_in_row(row, [&](unsigned int col) { sum_h += authority[col]; });
+				this->L_t_matrix.for_each_in_row(row, [&](unsigned int col) { sum_a += hub[col]; });
+				next_hub[row] = sum_h;
+				next_authority[row] = sum_a;
+				reply.values[0] += sum_a;
+				reply.values[1] += sum_h;
+			}
+		}
+		else if (message.command == HITS_NORMALIZE) {
+			for (unsigned int i = lo; i < hi; i++) {
+				next_authority[i] /= message.values[0];
+				next_hub[i] /= message.values[1];
+				reply.values[0] += std::pow(std::abs(authority[i] - next_authority[i]), 2.);
+				reply.values[1] += std::pow(std::abs(hub[i] - next_hub[i]), 2.);
+			}
+			std::swap(authority, next_authority);
+			std::swap(hub, next_hub);
+		}
+		return reply;
+	});
+
+	this->traffic = PartitionTraffic();
+	this->traffic.workers = workers;
+	PartitionMessage message;
+	message.command = HITS_TRAFFIC;
+	for (const PartitionMessage& reply : group.broadcast(message)) {
+		this->traffic.cut_edges += reply.values[0];
+		this->traffic.remote_entries += reply.values[1];
+	}
 
-        this->normalize(temp_HITS_authority, temp_HITS_hub);		
-    } while (this->converge(temp_HITS_authority, temp_HITS_hub));
+	bool running;
+	do {
+		this->steps++;
+		this->traffic.steps++;
+
+		double sum_a = 0., sum_h = 0.;
+		message = PartitionMessage();
+		message.command = HITS_STEP;
+		for (const PartitionMessage& reply : group.broadcast(message)) {
+			sum_a += reply.values[0];
+			sum_h += reply.values[1];
+		}
+
+		double distance_a = 0., distance_h = 0.;
+		message.command = HITS_NORMALIZE;
+		message.values[0] = sum_a;
+		message.values[1] = sum_h;
+		for (const PartitionMessage& reply : group.broadcast(message)) {
+			distance_a += reply.values[0];
+			distance_h += reply.values[1];
+		}
+		std::swap(authority, next_authority);
+		std::swap(hub, next_hub);
+
+		this->authority_residuals.push_back(std::sqrt(distance_a));
+		this->hub_residuals.push_back(std::sqrt(distance_h));
+		running = std::sqrt(distance_a) > std::pow(10, -10) && std::sqrt(distance_h) > std::pow(10, -10);
+
+		// snapshotting the state, the file is written by a background thread
+		if (running && this->checkpointer.due(this->steps)) {
+			std::copy(authority, authority + size, this->HITS_authority.begin());
+			std::copy(hub, hub + size, this->HITS_hub.begin());
+			this->checkpointer.save_async(this->get_state());
+		}
+	} while (running);
+
+	group.stop();
+	this->traffic.control_bytes = group.control_bytes;
+	this->elapsed = now() - start;
+
+	std::copy(authority, authority + size, this->HITS_authority.begin());
+	std::copy(hub, hub + size, this->HITS_hub.begin());
+	for (double* array : {authority, hub, next_authority, next_hub})
+		free_shared_array(array, size);
+
+	// the final state is always saved, so that it can seed new runs
+	if (this->checkpointer.enabled())
+		this->checkpointer.save(this->get_state());
+}
+
+// Function that computes autority and hub vectors as the dominant right and left singular vectors of L,
+// using the Lanczos bidiagonalization instead of the alternating power iteration.
+void HITS::compute_lanczos(unsigned int rank, unsigned int subspace){
+	auto start = now();
+
+	SVDResult svd = lanczos_svd(this->L_matrix, this->L_t_matrix, rank, subspace, std::pow(10, -10), 1000, this->HITS_authority);
+
+	// the dominant singular vectors of a non negative matrix can be chosen non negative, the sign is arbitrary
+	auto to_distribution = [](std::vector<double> v) {
+		for (double& value : v) value = std::abs(value);
+		double sum = std::accumulate(v.begin(), v.end(), 0.);
+		for (double& value : v) value /= sum;
+		return v;
+	};
+
+	this->HITS_authority = to_distribution(svd.right[0]);
+	this->HITS_hub = to_distribution(svd.left[0]);
+	this->singular_values = svd.singular_values;
+	this->authority_residuals = svd.residuals;
+	this->steps += svd.steps;
+
+	if (rank > 1) {
+		this->singular_authority = svd.right;
+		this->singular_hub = svd.left;
+	}
 	
 	this->elapsed = now() - start;
 }
 
 // Function that establishes whether the execution of the HITS algorithm should continue or not.
-bool HITS::converge(std::unordered_map<unsigned int, double> &temp_a, std::unordered_map<unsigned int, double> &temp_h){
+bool HITS::converge(std::vector<double> &temp_a, std::vector<double> &temp_h){
 	double distance_a = 0.;
 	double distance_h = 0.;
 
@@ -207,23 +322,27 @@ bool HITS::converge(std::unordered_map<unsigned int, double> &temp_a, std::unord
 	for (unsigned int i = 0; i < temp_h.size(); i++) 
 		distance_h += std::pow(std::abs(this->HITS_hub[i] - temp_h[i]), 2.);
 
-	this->HITS_authority = temp_a;
-	this->HITS_hub = temp_h;
+	this->authority_residuals.push_back(std::sqrt(distance_a));
+	this->hub_residuals.push_back(std::sqrt(distance_h));
+
+	// the old vectors are reused as the next temporary ones
+	std::swap(this->HITS_authority, temp_a);
+	std::swap(this->HITS_hub, temp_h);
 
 	return std::sqrt(distance_a) > std::pow(10, -10) && std::sqrt(distance_h) > std::pow(10, -10);
 }
 
 // Function that normalizes the vectors in order to obtain a probability distribution.
-void HITS::normalize(std::unordered_map<unsigned int, double> &ak, std::unordered_map<unsigned int, double> &hk){
+void HITS::normalize(std::vector<double> &ak, std::vector<double> &hk){
 	double sum_a_k = 0.0;
 	double sum_h_k = 0.0;
 	
-	for (unsigned int i = 0; i < this->graph.nodes; i++){
+	for (unsigned int i = 0; i < ak.size(); i++){
 		sum_a_k += ak[i];
 		sum_h_k += hk[i];
 	}
 
-	for (unsigned int i = 0; i < this->graph.nodes; i++){
+	for (unsigned int i = 0; i < ak.size(); i++){
 		ak[i] = ak[i] / sum_a_k;
 		hk[i] = hk[i] / sum_h_k;
 	}
@@ -231,11 +350,55 @@ void HITS::normalize(std::unordered_map<unsigned int, double> &ak, std::unordere
 
 // Function that frees the memory from the matrices created during the computing phase.
 void HITS::free_matrices_memory(){
-	if (munmap(this->L_ptr, this->graph.edges) != 0)
-    	throw std::runtime_error("Free memory failed\n");
+	this->L_matrix.freeMemory();
+	this->L_t_matrix.freeMemory();
+}
 	
-	if (munmap(this->L_t_ptr, this->graph.edges) != 0)
-    	throw std::runtime_error("Free memory failed\n");
+// Function that returns a snapshot of the actual state of the computation.
+CheckpointState HITS::get_state() {
+	CheckpointState state;
+	state.algo = "HITS";
+	state.fingerprint = this->graph.fingerprint;
+	state.steps = this->steps;
+	state.vectors = {this->HITS_authority, this->HITS_hub};
+	state.residuals = {this->authority_residuals, this->hub_residuals};
+	return state;
+}
+
+// Function that enables the checkpointing of the state every given number of steps.
+void HITS::enable_checkpoint(std::string path, unsigned int every) {
+	this->checkpointer = Checkpointer(path, every);
+}
+
+// Function that reads the authority and hub vectors of a checkpoint, validating the graph fingerprint if requested.
+bool HITS::load_state(std::string path, bool validate) {
+	CheckpointState state;
+	if (!Checkpointer::load(path, state))
+		return false;
+
+	if (state.algo != "HITS" || (validate && state.fingerprint != this->graph.fingerprint) || state.vectors.size() != 2 ||
+		state.vectors[0].size() != this->HITS_authority.size() || state.vectors[1].size() != this->HITS_hub.size())
+		throw std::runtime_error("Checkpoint does not match the graph\n");
+
+	this->HITS_authority = state.vectors[0];
+	this->HITS_hub = state.vectors[1];
+
+	if (validate) {
+		this->steps = state.steps;
+		this->authority_residuals = state.residuals.size() == 2 ? state.residuals[0] : std::vector<double>();
+		this->hub_residuals = state.residuals.size() == 2 ? state.residuals[1] : std::vector<double>();
+	}
+	return true;
+}
+
+// Function that restores the state saved in a checkpoint, it returns false if there is no checkpoint.
+bool HITS::resume(std::string path) {
+	return this->load_state(path, true);
+}
+
+// Function that uses the authority and hub vectors saved in a checkpoint as starting vectors of a new run, it returns false if there is no checkpoint.
+bool HITS::seed(std::string path) {
+	return this->load_state(path, false);
 }
 
 // Function that gets the top-k nodes w.r.t. the authority score.
@@ -251,7 +414,7 @@ void HITS::get_topk_hub() {
 // Function that prints the content of the authority vector.
 void HITS::print_authority(){
 	std::cout << "Values of a_k = [";
-	for (int i = 0; i < this->HITS_authority.size(); i++)
+	for (unsigned int i = 0; i < this->HITS_authority.size(); i++)
 		std::cout << HITS_authority[i] << ",";
 	
 	std::cout << "]\n";
@@ -260,7 +423,7 @@ void HITS::print_authority(){
 // Function that prints the content of the hub vector.
 void HITS::print_hub(){
 	std::cout << "Values of h_k = [";
-	for (int i = 0; i < this->HITS_hub.size(); i++)
+	for (unsigned int i = 0; i < this->HITS_hub.size(); i++)
 		std::cout << HITS_hub[i] << ",";
 	
 	std::cout << "]\n";
@@ -278,7 +441,37 @@ void HITS::print_topk_hub() {
 	this->graph.print_algo_topk_results(this->hub_topk, this->hub_str); 
 }
 
+// Function that returns the (node ID, authority score) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> HITS::get_authority_scores() {
+	return this->graph.get_scores(this->HITS_authority);
+}
+
+// Function that returns the (node ID, hub score) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> HITS::get_hub_scores() {
+	return this->graph.get_scores(this->HITS_hub);
+}
+
+// Function that returns the execution time and the number of steps taken by the HITS algorithm to converge.
+std::string HITS::get_stats() {
+	std::ostringstream stats;
+	stats << "Elapsed: " << this->elapsed.count() << " ms \t Steps: "<< this->steps << std::endl;
+	stats << "Compressed matrices: L " << this->L_matrix.bytes_per_edge() << " and L_t " << this->L_t_matrix.bytes_per_edge() << " bytes per edge" << std::endl;
+	if (this->traffic.workers > 0) stats << this->traffic.str(this->L_matrix.nnz + this->L_t_matrix.nnz);
+	return stats.str();
+}
+
+// Function that returns the singular values found by the Lanczos solver and the gap between the first two,
+// a ratio close to 1 means that the HITS ranking is not unique.
+std::string HITS::get_singular_values_str() {
+	std::ostringstream out;
+	out << "Singular values:";
+	for (double sigma : this->singular_values) out << " " << sigma;
+	if (this->singular_values.size() > 1) out << " \t sigma_2 / sigma_1: " << this->singular_values[1] / this->singular_values[0];
+	out << std::endl;
+	return out.str();
+}
+
 // Function that prints the execution time and the number of steps taken by the HITS algorithm to converge.
 void HITS::print_stats() {
-	std::cout << "Elapsed: " << this->elapsed.count() << " ms \t Steps: "<< this->steps << std::endl;
+	std::cout << this->get_stats();
 }
\ No newline at end of file
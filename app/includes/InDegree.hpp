@@ -1,15 +1,14 @@
 #include "Graph.hpp"
+#include "Ingest.hpp"
 
 // This class provides the implementation of the InDegree algorithm.
+// The in-links are counted while the dataset (plain or compressed) is parsed, so no edge is stored and no sort is needed.
 class InDegree {
 	public: 
 		// InDegree constructor.
 		InDegree(std::vector<unsigned int> top_k, std::string ds_path) {
 			this->top_k = top_k;
-			this->graph = Graph(ds_path);
-
-			std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.nodes, compareByFirstIncreasing);
-			std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.nodes, compareBySecondIncreasing);
+			this->ds_path = ds_path;
 		}
 
 		// Vector that indicates the k value for which the top-k ranking is computed.
@@ -20,29 +19,68 @@ class InDegree {
 
 		std::string algo_str = "In Degree"; 
 
-		// Unordered map that memorizes the actual InDegree Prestige for each node.
-		std::unordered_map<unsigned int, double> In_Deg_Prestige; 
+		// Vector that memorizes the actual InDegree Prestige for each node (indexed by node ID - min_node).
+		std::vector<double> In_Deg_Prestige; 
+
+		// Number of nodes and edges, and node ID range.
+		int nodes = 0;
+		int edges = 0;
+		unsigned int min_node = UINT_MAX;
+		unsigned int max_node = 0;
 
-		// Elapsed time
+		// Elapsed time, the parsing of the dataset included.
 		Duration elapsed;
 
 		// Public functions declaration
 
-		void compute();
+		void compute(unsigned int workers = default_workers());
 		void get_topk_results();
 		void print_topk_results();
 		void print_stats();
+		std::string get_stats();
+		std::vector<std::pair<unsigned int, double>> get_scores();
 		
 	private:
-		Graph graph;
+		std::string ds_path;
 };
 
-// Function that computes the InDegree value of each node analysing the edges.
-void InDegree::compute() {
+// Function that computes the InDegree value of each node while parsing the edges.
+void InDegree::compute(unsigned int workers) {
 	// timer start
 	auto start = now();
-	for(unsigned int i = 0; i < this->graph.edges; i++)
-		this->In_Deg_Prestige[this->graph.np_pointer[i].second] += 1 / (this->graph.nodes - 1);
+
+	read_snap_header(read_file_head(this->ds_path), this->nodes, this->edges);
+
+	// one dense histogram of the destination nodes for each worker, indexed by node ID
+	std::vector<std::vector<unsigned int>> histograms(workers, std::vector<unsigned int>(std::max(this->nodes, 1), 0));
+	std::vector<unsigned int> min_nodes(workers, UINT_MAX), max_nodes(workers, 0);
+	std::vector<unsigned int> edge_counts(workers, 0);
+
+	for_each_edge(this->ds_path, workers, [&](unsigned int w, unsigned int from, unsigned int to) {
+		std::vector<unsigned int>& histogram = histograms[w];
+		if (to >= histogram.size()) histogram.resize(std::max<size_t>(to + 1, histogram.size() * 2), 0);
+		histogram[to]++;
+
+		min_nodes[w] = std::min({min_nodes[w], from, to});
+		max_nodes[w] = std::max({max_nodes[w], from, to});
+		edge_counts[w]++;
+	});
+
+	this->min_node = *std::min_element(min_nodes.begin(), min_nodes.end());
+	this->max_node = *std::max_element(max_nodes.begin(), max_nodes.end());
+	this->edges = std::accumulate(edge_counts.begin(), edge_counts.end(), 0u);
+	if (this->edges == 0)
+		throw std::runtime_error("The dataset has no edges\n");
+
+	// merging the histograms and normalizing by n - 1 in a single pass
+	const double norm = 1. / (this->nodes - 1);
+	this->In_Deg_Prestige.assign(this->max_node - this->min_node + 1, 0.);
+	for (unsigned int i = 0; i < this->In_Deg_Prestige.size(); i++) {
+		unsigned int count = 0;
+		for (const std::vector<unsigned int>& histogram : histograms)
+			if (i + this->min_node < histogram.size()) count += histogram[i + this->min_node];
+		this->In_Deg_Prestige[i] = count * norm;
+	}
 	
 	// ending the timing
 	this->elapsed = now() - start; 
@@ -50,16 +88,31 @@ void InDegree::compute() {
 
 // Function that retreives the top-k nodes based on the InDegree value of each node.
 void InDegree::get_topk_results() {
-	this->graph.get_algo_topk_results(this->In_Deg_Prestige, this->top_k, this->IN_topk);
-	this->graph.freeMemory();
+	select_topk(this->get_scores(), this->top_k, this->IN_topk);
 }
 
 // Function that prints the results.
 void InDegree::print_topk_results() {
-	this->graph.print_algo_topk_results(this->IN_topk, this->algo_str);
+	write_all(stdout, format_topk(this->IN_topk, this->algo_str));
+	std::fflush(stdout);
+}
+
+// Function that returns the (node ID, InDegree Prestige) pairs of the nodes with at least one in-link.
+std::vector<std::pair<unsigned int, double>> InDegree::get_scores() {
+	std::vector<std::pair<unsigned int, double>> pairs;
+	for (unsigned int i = 0; i < this->In_Deg_Prestige.size(); i++)
+		if (this->In_Deg_Prestige[i] > 0.) pairs.push_back(std::make_pair(i + this->min_node, this->In_Deg_Prestige[i]));
+	return pairs;
+}
+
+// Function that returns the elapsed time.
+std::string InDegree::get_stats() {
+	std::ostringstream stats;
+	stats << "Elapsed: " << this->elapsed.count() << " ms" << std::endl;
+	return stats.str();
 }
 
 // Function that prints the elapsed time.
 void InDegree::print_stats() {
-	std::cout << "Elapsed: " << this->elapsed.count() << " ms" << std::endl;
-}
\ No newline at end of file
+	std::cout << this->get_stats();
+}
@@ -0,0 +1,349 @@
+#ifndef _INGEST_H
+#define _INGEST_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <sstream>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "./Utils.hpp"
+
+// Size of the chunks of decompressed text handed to the parser threads.
+const size_t INGEST_CHUNK_SIZE = 4 << 20;
+
+// Compression formats of a dataset file.
+enum class InputFormat { Plain, Gzip, Zstd };
+
+// Function that reads the number of nodes and edges from the "# Nodes: N Edges: M" line of a SNAP file header.
+void read_snap_header(const std::string& text, int& nodes, int& edges) {
+	std::istringstream text_stream(text);
+	std::string line;
+
+	while (std::getline(text_stream, line) && !line.empty() && line[0] == '#') {
+		std::istringstream line_stream(line);
+		std::string str;
+		while (line_stream >> str) {
+			if (str == "Nodes:")
+				line_stream >> nodes;
+			else if (str == "Edges:")
+				line_stream >> edges;
+		}
+	}
+}
+
+// Function that parses the edges of a chunk of a SNAP file ("from<TAB>to" lines, "#" lines are comments) and calls on_edge for each of them.
+// The chunk must start at the beginning of a line.
+template<typename OnEdge>
+void parse_edges(const char* p, const char* end, OnEdge on_edge) {
+	while (p < end) {
+		if (*p == '#') {
+			while (p < end && *p != '\n') p++;
+			p++;
+			continue;
+		}
+
+		unsigned int from = 0, to = 0;
+		bool has_from = false, has_to = false;
+
+		while (p < end && (*p == ' ' || *p == '\t')) p++;
+		for (; p < end && *p >= '0' && *p <= '9'; p++, has_from = true) from = from * 10 + (*p - '0');
+		while (p < end && (*p == ' ' || *p == '\t')) p++;
+		for (; p < end && *p >= '0' && *p <= '9'; p++, has_to = true) to = to * 10 + (*p - '0');
+
+		if (has_from && has_to) on_edge(from, to);
+
+		// skipping the rest of the line (\r included)
+		while (p < end && *p != '\n') p++;
+		p++;
+	}
+}
+
+// Function that maps a SNAP file in memory and parses it with the given number of workers, calling on_edge(worker, from, to) for each edge.
+// Each worker parses a contiguous slice of the file, starting at the first line that begins inside its slice.
+template<typename OnEdge>
+void for_each_edge_parallel(const std::string& path, unsigned int workers, OnEdge on_edge) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("Could not open file");
+
+	struct stat st;
+	fstat(fd, &st);
+	size_t size = st.st_size;
+	if (size == 0) {
+		close(fd);
+		return;
+	}
+
+	const char* data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		throw std::runtime_error("Mapping " + path + " Failed\n");
+	madvise((void*)data, size, MADV_SEQUENTIAL);
+
+	// moving a split point to the beginning of the next line
+	auto line_start = [&](size_t pos) {
+		if (pos == 0 || pos >= size) return std::min(pos, size);
+		const char* newline = (const char*)memchr(data + pos - 1, '\n', size - pos + 1);
+		return newline == NULL ? size : (size_t)(newline - data) + 1;
+	};
+
+	parallel_run(workers, [&](unsigned int w) {
+		size_t begin = line_start(size * w / workers);
+		size_t end = line_start(size * (w + 1) / workers);
+		parse_edges(data + begin, data + end, [&](unsigned int from, unsigned int to) { on_edge(w, from, to); });
+	});
+
+	munmap((void*)data, size);
+}
+
+// Function that detects the compression format of a file from its magic number.
+InputFormat input_format(const std::string& path) {
+	std::ifstream file = readDataset(path);
+	unsigned char magic[4] = {0, 0, 0, 0};
+	file.read((char*)magic, sizeof(magic));
+
+	if (file.gcount() >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+		return InputFormat::Gzip;
+	if (file.gcount() == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+		return InputFormat::Zstd;
+	return InputFormat::Plain;
+}
+
+// Function that returns the path of a dataset, looking for its compressed versions (.gz, .zst) if the plain file does not exist.
+std::string resolve_dataset(const std::string& path) {
+	for (const std::string& candidate : {path, path + ".gz", path + ".zst"})
+		if (std::filesystem::exists(candidate))
+			return candidate;
+	return path;
+}
+
+// Function that decompresses a gzip file block by block, calling on_block(data, size) for each decompressed block.
+// Stop is polled after each block, when it returns true the decompression ends early.
+template<typename OnBlock, typename Stop>
+void decompress_gzip(const std::string& path, OnBlock on_block, Stop stop) {
+	gzFile file = gzopen(path.c_str(), "rb");
+	if (file == NULL)
+		throw std::runtime_error("Could not open file");
+	gzbuffer(file, 1 << 20);
+
+	std::vector<char> block(1 << 20);
+	int size = 0;
+	while (!stop() && (size = gzread(file, block.data(), block.size())) > 0)
+		on_block(block.data(), (size_t)size);
+
+	int error;
+	std::string message = size < 0 ? gzerror(file, &error) : "";
+	gzclose(file);
+	if (size < 0)
+		throw std::runtime_error("Decompression of " + path + " failed: " + message + "\n");
+}
+
+// Function that decompresses a zstd file block by block, calling on_block(data, size) for each decompressed block.
+// Stop is polled after each block, when it returns true the decompression ends early.
+template<typename OnBlock, typename Stop>
+void decompress_zstd(const std::string& path, OnBlock on_block, Stop stop) {
+#ifdef HAVE_ZSTD
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		throw std::runtime_error("Could not open file");
+
+	ZSTD_DStream* stream = ZSTD_createDStream();
+	ZSTD_initDStream(stream);
+	std::vector<char> in(ZSTD_DStreamInSize()), out(ZSTD_DStreamOutSize());
+
+	while (!stop() && file.read(in.data(), in.size()).gcount() > 0) {
+		ZSTD_inBuffer input = {in.data(), (size_t)file.gcount(), 0};
+		while (input.pos < input.size) {
+			ZSTD_outBuffer output = {out.data(), out.size(), 0};
+			size_t result = ZSTD_decompressStream(stream, &output, &input);
+			if (ZSTD_isError(result)) {
+				ZSTD_freeDStream(stream);
+				throw std::runtime_error("Decompression of " + path + " failed: " + ZSTD_getErrorName(result) + "\n");
+			}
+			on_block(out.data(), output.pos);
+		}
+	}
+	ZSTD_freeDStream(stream);
+#else
+	(void)on_block;
+	(void)stop;
+	throw std::runtime_error(path + " is compressed with zstd, rebuild with -DHAVE_ZSTD -lzstd to read it\n");
+#endif
+}
+
+// Function that decompresses a gzip or zstd file block by block, calling on_block(data, size) for each decompressed block.
+template<typename OnBlock, typename Stop>
+void decompress_file(const std::string& path, OnBlock on_block, Stop stop) {
+	if (input_format(path) == InputFormat::Zstd)
+		decompress_zstd(path, on_block, stop);
+	else
+		decompress_gzip(path, on_block, stop);
+}
+
+// Class that implements a bounded queue of text chunks between the decompression thread and the parser threads.
+class ChunkQueue {
+	public:
+		// ChunkQueue constructor.
+		ChunkQueue(size_t capacity) {
+			this->capacity = capacity;
+		}
+
+		// Public functions declaration
+
+		bool push(std::string chunk);
+		bool pop(std::string& chunk);
+		void close();
+
+	private:
+		size_t capacity;
+		bool closed = false;
+		std::vector<std::string> chunks;
+		std::mutex mutex;
+		std::condition_variable not_full;
+		std::condition_variable not_empty;
+};
+
+// Function that adds a chunk to the queue, waiting while the queue is full; it returns false if the queue was closed, e.g. by a failed consumer.
+bool ChunkQueue::push(std::string chunk) {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->not_full.wait(lock, [&]() { return this->chunks.size() < this->capacity || this->closed; });
+	if (this->closed) return false;
+
+	this->chunks.push_back(std::move(chunk));
+	this->not_empty.notify_one();
+	return true;
+}
+
+// Function that takes a chunk from the queue, it returns false when the queue is closed and empty.
+bool ChunkQueue::pop(std::string& chunk) {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->not_empty.wait(lock, [&]() { return !this->chunks.empty() || this->closed; });
+	if (this->chunks.empty()) return false;
+
+	// the order of the chunks does not matter, the last one is the cheapest to take
+	chunk = std::move(this->chunks.back());
+	this->chunks.pop_back();
+	this->not_full.notify_one();
+	return true;
+}
+
+// Function that closes the queue: the producer stops adding chunks and the consumers stop when it is empty.
+void ChunkQueue::close() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->closed = true;
+	this->not_full.notify_all();
+	this->not_empty.notify_all();
+}
+
+// Function that parses a SNAP text produced block by block with a pipeline: one thread runs read_blocks(on_block), which produces the
+// text, and cuts it in chunks at line boundaries; the given number of workers parse the chunks taken from a bounded queue, calling
+// on_edge(worker, from, to). If a worker fails, the queue is closed so that the reader drops the rest of the text instead of blocking.
+template<typename ReadBlocks, typename OnEdge>
+void parse_pipeline(ReadBlocks read_blocks, unsigned int workers, OnEdge on_edge) {
+	ChunkQueue queue(2 * workers);
+	std::exception_ptr error;
+
+	std::thread reader([&]() {
+		std::string pending;
+		bool open = true;
+		try {
+			read_blocks([&](const char* data, size_t size) {
+				if (!open) return;
+				pending.append(data, size);
+				if (pending.size() < INGEST_CHUNK_SIZE) return;
+
+				// the incomplete last line is kept for the next chunk
+				size_t last = pending.rfind('\n');
+				if (last == std::string::npos) return;
+				std::string chunk(pending, 0, last + 1);
+				pending.erase(0, last + 1);
+				open = queue.push(std::move(chunk));
+			});
+
+			if (open && !pending.empty()) queue.push(std::move(pending));
+		} catch (...) {
+			error = std::current_exception();
+		}
+		queue.close();
+	});
+
+	try {
+		parallel_run(workers, [&](unsigned int w) {
+			std::string chunk;
+			try {
+				while (queue.pop(chunk))
+					parse_edges(chunk.data(), chunk.data() + chunk.size(), [&](unsigned int from, unsigned int to) { on_edge(w, from, to); });
+			} catch (...) {
+				// the other workers stop at the chunks already queued
+				queue.close();
+				throw;
+			}
+		});
+	} catch (...) {
+		queue.close();
+		reader.join();
+		throw;
+	}
+
+	reader.join();
+	if (error) std::rethrow_exception(error);
+}
+
+// Function that parses a compressed SNAP file with a pipeline: one thread decompresses the file, the given number of workers
+// parse the decompressed text, calling on_edge(worker, from, to).
+template<typename OnEdge>
+void for_each_edge_pipelined(const std::string& path, unsigned int workers, OnEdge on_edge) {
+	parse_pipeline([&](auto on_block) { decompress_file(path, on_block, []() { return false; }); }, workers, on_edge);
+}
+
+// Function that parses a SNAP stream (e.g. the standard input) with a pipeline: one thread reads the stream, the given number of
+// workers parse it, calling on_edge(worker, from, to). The first bytes of the stream, with the header, are copied in head.
+template<typename OnEdge>
+void for_each_edge_stream(FILE* stream, unsigned int workers, OnEdge on_edge, std::string& head) {
+	parse_pipeline([&](auto on_block) {
+		std::vector<char> block(1 << 20);
+		size_t size;
+		while ((size = std::fread(block.data(), 1, block.size(), stream)) > 0) {
+			if (head.size() < 4096) head.append(block.data(), std::min(size, 4096 - head.size()));
+			on_block(block.data(), size);
+		}
+		if (std::ferror(stream))
+			throw std::runtime_error("Reading the stream failed\n");
+	}, workers, on_edge);
+}
+
+// Function that parses a SNAP file, plain or compressed, with the given number of workers, calling on_edge(worker, from, to) for each edge.
+template<typename OnEdge>
+void for_each_edge(const std::string& path, unsigned int workers, OnEdge on_edge) {
+	if (input_format(path) == InputFormat::Plain)
+		for_each_edge_parallel(path, workers, on_edge);
+	else
+		for_each_edge_pipelined(path, workers, on_edge);
+}
+
+// Function that returns the beginning of a file, enough to read the SNAP header; compressed files are decompressed on the fly.
+std::string read_file_head(const std::string& path) {
+	std::string head;
+
+	if (input_format(path) != InputFormat::Plain) {
+		decompress_file(path, [&](const char* data, size_t size) { head.append(data, std::min(size, 4096 - head.size())); },
+						[&]() { return head.size() >= 4096; });
+		return head;
+	}
+
+	std::ifstream file = readDataset(path);
+	head.resize(4096);
+	file.read(head.data(), head.size());
+	head.resize(file.gcount());
+	return head;
+}
+
+#endif
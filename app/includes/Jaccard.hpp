@@ -21,6 +21,7 @@ class JaccardCoefficient {
 
 		void obtain_results();
 		void print_results();
+		std::string format_results();
 		void save_results(std::fstream &stream_jaccard, std::string &ds);
 
 	private:
@@ -48,8 +49,8 @@ std::map<unsigned int, std::vector<unsigned int>> JaccardCoefficient::get_first_
 
 	for(unsigned int k : this->topk) {
 
-		// initializing the IDs vector with size k
-		std::vector<unsigned int> firstElements(k); 
+		// initializing the IDs vector with the size of the ranking, which is smaller than k when the graph has fewer nodes
+		std::vector<unsigned int> firstElements(topk_vector[k].size());
 
 		std::transform(topk_vector[k].begin(), topk_vector[k].end(), firstElements.begin(),
 						[](const std::pair<unsigned int, double> &pair) {
@@ -108,23 +109,40 @@ void JaccardCoefficient::obtain_results() {
 	}
 }
 
+// Function that formats the results.
+std::string JaccardCoefficient::format_results() {
+	std::string out;
+	for(auto& pair1 : this->jaccard_results) {
+		out += "TOP ";
+		append_uint(out, pair1.first);
+		for(auto& result : pair1.second) {
+			out += "\t" + result.first + ": ";
+			append_double(out, result.second);
+			out += '\n';
+		}
+		out += '\n';
+	}
+	return out;
+}
+
 // Function that prints the results.
 void JaccardCoefficient::print_results() {
-	for(auto pair1 : this->jaccard_results) {
-		std::cout << "TOP " << pair1.first;
-		for(auto result : pair1.second)
-			std::cout << "\t" << result.first << ": " << result.second << std::endl; 
-		std::cout << std::endl;
-	}
+	std::cout << this->format_results();
 }
 
-// Function that saves the jaccard coefficients in a .csv file.
+// Function that saves the jaccard coefficients in a .csv file, the rows are formatted in memory and written at once.
 void JaccardCoefficient::save_results(std::fstream &stream_jaccard, std::string &ds) {
-	for(auto pair1 : this->jaccard_results) {
-		stream_jaccard << ds << "," << pair1.first;
-		for(auto result : pair1.second) stream_jaccard << "," << result.second; 
-		stream_jaccard << '\n';
+	std::string rows;
+	for(auto& pair1 : this->jaccard_results) {
+		rows += ds + ",";
+		append_uint(rows, pair1.first);
+		for(auto& result : pair1.second) {
+			rows += ',';
+			append_double(rows, result.second);
+		}
+		rows += '\n';
 	}
+	stream_jaccard.write(rows.data(), rows.size());
 }
 
 #endif
\ No newline at end of file
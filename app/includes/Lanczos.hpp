@@ -0,0 +1,224 @@
+#ifndef _LANCZOS_H
+#define _LANCZOS_H
+
+#include "./Compressed.hpp"
+#include <cmath>
+
+// Structure that holds the dominant singular triplets of a matrix L: L * right[i] = sigma[i] * left[i].
+struct SVDResult {
+	// Singular values in decreasing order.
+	std::vector<double> singular_values;
+
+	// Left singular vectors (hub vectors for HITS).
+	std::vector<std::vector<double>> left;
+
+	// Right singular vectors (authority vectors for HITS).
+	std::vector<std::vector<double>> right;
+
+	// Relative residual of the dominant triplet at the end of each restart.
+	std::vector<double> residuals;
+
+	// Number of steps, each step is one product with L and one with L_t.
+	unsigned int steps = 0;
+};
+
+// Function that returns the dot product of two vectors.
+inline double dot(const std::vector<double>& x, const std::vector<double>& y) {
+	double sum = 0.;
+	for (size_t i = 0; i < x.size(); i++) sum += x[i] * y[i];
+	return sum;
+}
+
+// Function that computes y = y + a * x.
+inline void axpy(double a, const std::vector<double>& x, std::vector<double>& y) {
+	for (size_t i = 0; i < x.size(); i++) y[i] += a * x[i];
+}
+
+// Function that scales a vector.
+inline void scale(std::vector<double>& x, double a) {
+	for (double& value : x) value *= a;
+}
+
+// Function that orthogonalizes a vector against a set of orthonormal vectors (classical Gram-Schmidt applied twice).
+void reorthogonalize(std::vector<double>& x, const std::vector<std::vector<double>>& basis, size_t count) {
+	for (int pass = 0; pass < 2; pass++)
+		for (size_t i = 0; i < count; i++)
+			axpy(-dot(basis[i], x), basis[i], x);
+}
+
+// Function that computes the eigen decomposition of a small symmetric matrix (m x m, row major) with the cyclic Jacobi method.
+// The eigenvalues are returned in decreasing order, the eigenvectors as columns of vectors.
+void symmetric_eigen(std::vector<double> A, unsigned int m, std::vector<double>& values, std::vector<double>& vectors) {
+	vectors.assign(m * m, 0.);
+	for (unsigned int i = 0; i < m; i++) vectors[i * m + i] = 1.;
+
+	for (int sweep = 0; sweep < 100; sweep++) {
+		double off = 0.;
+		for (unsigned int p = 0; p < m; p++)
+			for (unsigned int q = p + 1; q < m; q++) off += A[p * m + q] * A[p * m + q];
+		if (off < 1e-30) break;
+
+		for (unsigned int p = 0; p < m; p++) {
+			for (unsigned int q = p + 1; q < m; q++) {
+				if (std::abs(A[p * m + q]) < 1e-300) continue;
+
+				// rotation that annihilates A[p][q]
+				double theta = (A[q * m + q] - A[p * m + p]) / (2. * A[p * m + q]);
+				double t = (theta >= 0 ? 1. : -1.) / (std::abs(theta) + std::sqrt(theta * theta + 1.));
+				double c = 1. / std::sqrt(t * t + 1.), s = t * c;
+
+				for (unsigned int k = 0; k < m; k++) {
+					double akp = A[k * m + p], akq = A[k * m + q];
+					A[k * m + p] = c * akp - s * akq;
+					A[k * m + q] = s * akp + c * akq;
+				}
+				for (unsigned int k = 0; k < m; k++) {
+					double apk = A[p * m + k], aqk = A[q * m + k];
+					A[p * m + k] = c * apk - s * aqk;
+					A[q * m + k] = s * apk + c * aqk;
+				}
+				for (unsigned int k = 0; k < m; k++) {
+					double vkp = vectors[k * m + p], vkq = vectors[k * m + q];
+					vectors[k * m + p] = c * vkp - s * vkq;
+					vectors[k * m + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	// sorting the eigenpairs by decreasing eigenvalue
+	std::vector<unsigned int> order(m);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](unsigned int i, unsigned int j) { return A[i * m + i] > A[j * m + j]; });
+
+	std::vector<double> sorted_vectors(m * m);
+	values.resize(m);
+	for (unsigned int c = 0; c < m; c++) {
+		values[c] = A[order[c] * m + order[c]];
+		for (unsigned int k = 0; k < m; k++) sorted_vectors[k * m + c] = vectors[k * m + order[c]];
+	}
+	vectors = sorted_vectors;
+}
+
+// Function that computes the dominant singular triplets of L with the thick restarted Golub-Kahan-Lanczos bidiagonalization.
+// Each cycle extends a Krylov subspace of the given size with full reorthogonalization; at the restart the best Ritz triplets
+// are kept together with the residual vector, so that no information about the wanted triplets is lost. The iteration stops
+// when the residual of the wanted triplets falls below the tolerance (relative to sigma_1).
+SVDResult lanczos_svd(const CompressedMatrix& L, const CompressedMatrix& L_t, unsigned int rank, unsigned int subspace,
+					  double tolerance, unsigned int max_steps, std::vector<double> start) {
+	SVDResult result;
+	unsigned int n = L_t.rows;
+	unsigned int m = std::max(subspace, rank + 2);
+
+	std::vector<std::vector<double>> U(m, std::vector<double>(n)), V(m + 1, std::vector<double>(n));
+
+	// projected matrix B = U_m^t * L * V_m, upper bidiagonal except for the row of couplings of the kept triplets
+	std::vector<double> B(m * m, 0.);
+
+	// number of kept Ritz triplets and their coupling with the residual vector
+	unsigned int kept = 0;
+	std::vector<double> rho;
+
+	V[0] = start;
+	scale(V[0], 1. / std::sqrt(dot(V[0], V[0])));
+	double beta = 0.;
+
+	while (true) {
+		unsigned int size = kept;
+
+		// extending the bidiagonalization: L * V_m = U_m * B,   L_t * U_m = V_m * B^t + beta * v_m+1 * e_m^t
+		while (size < m) {
+			unsigned int j = size;
+			L.multiply(V[j], U[j]);
+			if (j == kept && kept > 0)
+				for (unsigned int i = 0; i < kept; i++) axpy(-rho[i], U[i], U[j]);
+			else if (j > 0)
+				axpy(-beta, U[j - 1], U[j]);
+			reorthogonalize(U[j], U, j);
+			double alpha = std::sqrt(dot(U[j], U[j]));
+			if (alpha == 0.) break;
+			scale(U[j], 1. / alpha);
+
+			B[j * m + j] = alpha;
+			if (j == kept && kept > 0)
+				for (unsigned int i = 0; i < kept; i++) B[i * m + j] = rho[i];
+			else if (j > 0)
+				B[(j - 1) * m + j] = beta;
+
+			L_t.multiply(U[j], V[j + 1]);
+			axpy(-alpha, V[j], V[j + 1]);
+			reorthogonalize(V[j + 1], V, j + 1);
+			beta = std::sqrt(dot(V[j + 1], V[j + 1]));
+			if (beta > 0.) scale(V[j + 1], 1. / beta);
+
+			size++;
+			result.steps++;
+
+			// invariant subspace found, the Ritz values are exact
+			if (beta <= 1e-14 * alpha) break;
+		}
+
+		if (size == 0)
+			throw std::runtime_error("The adjacency matrix is zero\n");
+
+		// singular value decomposition of B through the eigen decomposition of B^t * B
+		std::vector<double> BtB(size * size, 0.);
+		for (unsigned int i = 0; i < size; i++)
+			for (unsigned int j = 0; j < size; j++)
+				for (unsigned int k = 0; k < size; k++) BtB[i * size + j] += B[k * m + i] * B[k * m + j];
+
+		std::vector<double> values, Q;
+		symmetric_eigen(BtB, size, values, Q);
+
+		// P = B * Q / sigma, the residual of the c-th triplet is beta * |P[size - 1][c]|
+		std::vector<double> sigma(size), P(size * size, 0.);
+		for (unsigned int c = 0; c < size; c++) {
+			sigma[c] = std::sqrt(std::max(values[c], 0.));
+			for (unsigned int i = 0; i < size; i++) {
+				for (unsigned int k = 0; k < size; k++) P[i * size + c] += B[i * m + k] * Q[k * size + c];
+				P[i * size + c] /= sigma[c] > 0. ? sigma[c] : 1.;
+			}
+		}
+
+		unsigned int r = std::min(rank, size);
+		double worst = 0.;
+		for (unsigned int c = 0; c < r; c++)
+			worst = std::max(worst, beta * std::abs(P[(size - 1) * size + c]) / sigma[0]);
+		result.residuals.push_back(worst);
+
+		bool done = worst <= tolerance || result.steps >= max_steps || size < m;
+
+		// computing the Ritz vectors: the wanted ones at the end, the kept ones at a restart
+		unsigned int count = done ? r : std::min(size - 1, std::max(rank, size / 2));
+		std::vector<std::vector<double>> right(count, std::vector<double>(n, 0.)), left(count, std::vector<double>(n, 0.));
+		for (unsigned int c = 0; c < count; c++) {
+			for (unsigned int i = 0; i < size; i++) {
+				axpy(Q[i * size + c], V[i], right[c]);
+				axpy(P[i * size + c], U[i], left[c]);
+			}
+		}
+
+		if (done) {
+			result.singular_values.assign(sigma.begin(), sigma.begin() + r);
+			result.right = right;
+			result.left = left;
+			break;
+		}
+
+		// thick restart: V = [right Ritz vectors, residual vector], U = [left Ritz vectors], B = diag(sigma) plus the couplings
+		kept = count;
+		rho.assign(kept, 0.);
+		V[kept] = V[size];
+		for (unsigned int c = 0; c < kept; c++) {
+			V[c] = right[c];
+			U[c] = left[c];
+			rho[c] = beta * P[(size - 1) * size + c];
+		}
+		std::fill(B.begin(), B.end(), 0.);
+		for (unsigned int c = 0; c < kept; c++) B[c * m + c] = sigma[c];
+	}
+
+	return result;
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef _OPTIONS_H
+#define _OPTIONS_H
+
+#include "./Utils.hpp"
+
+// Structure that collects the command line options of the application.
+struct AppOptions {
+	// Directory where the checkpoints of PageRank and HITS are written and read.
+	std::string checkpoint_dir = "../checkpoints";
+
+	// Number of steps between two checkpoints, 0 disables the checkpointing.
+	unsigned int checkpoint_every = 0;
+
+	// Whether to resume PageRank and HITS from the checkpoints of a previous run.
+	bool resume = false;
+
+	// Whether to start PageRank and HITS from the final vectors of a previous run.
+	bool seed = false;
+
+	// PageRank solver: "power" (power iteration), "push" (residual push, asynchronous in each round), "lumped" (power iteration on the
+	// non dangling nodes only) or "scc" (lumped and solved component by component in topological order).
+	std::string pagerank_solver = "power";
+
+	// Bound on the L1 error of the push solver.
+	double push_tolerance = 1e-9;
+
+	// HITS solver: "power" (alternating power iteration) or "lanczos" (Lanczos bidiagonalization).
+	std::string hits_solver = "power";
+
+	// Number of singular triplets computed by the Lanczos solver and size of its Krylov subspace.
+	unsigned int hits_rank = 1;
+	unsigned int hits_subspace = 12;
+
+	// Whether to compute InDegree, PageRank and HITS together, with a single scan of the in-links per step.
+	bool fused = false;
+
+	// Number of worker processes of the partitioned PageRank and HITS, 0 computes them in this process.
+	unsigned int workers = 0;
+
+	// Whether to start the PageRank power iteration from the BlockRank vector, the size of the blocks of contiguous node IDs and the
+	// file that maps the nodes to their hosts (empty to use only the ranges), and whether to run the uniform start too to report the saving.
+	bool blockrank = false;
+	unsigned int blockrank_size = 1024;
+	std::string blockrank_hosts;
+	bool blockrank_compare = false;
+
+	// Whether to run InDegree, PageRank and HITS of a dataset at the same time, on the shared pool of threads.
+	bool concurrent = false;
+
+	// Directory of the result cache, and whether to use it. The cache is not used with checkpoints, whose runs start from a saved state.
+	std::string cache_dir = "../cache";
+	bool cache = true;
+
+	// Directory of the results of this run, empty for a new directory named after the start time.
+	std::string results_dir;
+};
+
+// Function that prints the list of the accepted options.
+void print_usage() {
+	std::cout << "Usage: ./app [options]\n"
+			  << "  --checkpoint <steps>      save the PageRank and HITS state every <steps> steps\n"
+			  << "  --checkpoint-dir <dir>    directory of the checkpoint files (default ../checkpoints)\n"
+			  << "  --resume                  resume PageRank and HITS from the checkpoint files\n"
+			  << "  --seed                    start PageRank and HITS from the vectors of the checkpoint files\n"
+			  << "  --pagerank-solver <s>     power (default), push, lumped or scc\n"
+			  << "  --push-tolerance <e>      bound on the L1 error of the push solver (default 1e-9)\n"
+			  << "  --hits-solver <solver>    power (default) or lanczos\n"
+			  << "  --hits-rank <r>           number of singular vectors computed by the lanczos solver (default 1)\n"
+			  << "  --hits-subspace <m>       size of the Krylov subspace of the lanczos solver (default 12)\n"
+			  << "  --fused                   compute InDegree, PageRank and HITS with a single scan of the in-links per step\n"
+			  << "  --workers <n>             compute PageRank and HITS with <n> local worker processes, each one owning a slice of the rows\n"
+			  << "  --blockrank               start the PageRank power iteration from the BlockRank vector\n"
+			  << "  --blockrank-size <n>      number of node IDs in each block of BlockRank (default 1024)\n"
+			  << "  --blockrank-hosts <file>  file of \"<node ID> <host>\" lines, the hosts are the blocks of BlockRank\n"
+			  << "  --blockrank-compare       also run the power iteration from the uniform vector and report the saving of BlockRank\n"
+			  << "  --concurrent              run InDegree, PageRank and HITS of a dataset at the same time\n"
+			  << "  --cache-dir <dir>         directory of the result cache (default ../cache)\n"
+			  << "  --no-cache                compute all the results again, without reading nor writing the cache\n"
+			  << "  --results-dir <dir>       directory of the results of this run (default ../results/<start time>)\n";
+}
+
+// Function that parses the command line options.
+AppOptions parse_options(int argc, char* argv[]) {
+	AppOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+
+		// returning the value of an option that requires one
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		if (arg == "--checkpoint")
+			options.checkpoint_every = std::stoul(value());
+		else if (arg == "--checkpoint-dir")
+			options.checkpoint_dir = value();
+		else if (arg == "--resume")
+			options.resume = true;
+		else if (arg == "--seed")
+			options.seed = true;
+		else if (arg == "--pagerank-solver")
+			options.pagerank_solver = value();
+		else if (arg == "--push-tolerance")
+			options.push_tolerance = std::stod(value());
+		else if (arg == "--hits-solver")
+			options.hits_solver = value();
+		else if (arg == "--hits-rank")
+			options.hits_rank = std::stoul(value());
+		else if (arg == "--hits-subspace")
+			options.hits_subspace = std::stoul(value());
+		else if (arg == "--fused")
+			options.fused = true;
+		else if (arg == "--workers")
+			options.workers = std::stoul(value());
+		else if (arg == "--blockrank")
+			options.blockrank = true;
+		else if (arg == "--blockrank-size") {
+			options.blockrank = true;
+			options.blockrank_size = std::stoul(value());
+		}
+		else if (arg == "--blockrank-hosts") {
+			options.blockrank = true;
+			options.blockrank_hosts = value();
+		}
+		else if (arg == "--blockrank-compare") {
+			options.blockrank = true;
+			options.blockrank_compare = true;
+		}
+		else if (arg == "--concurrent")
+			options.concurrent = true;
+		else if (arg == "--cache-dir")
+			options.cache_dir = value();
+		else if (arg == "--no-cache")
+			options.cache = false;
+		else if (arg == "--results-dir")
+			options.results_dir = value();
+		else if (arg == "--help") {
+			print_usage();
+			std::exit(0);
+		}
+		else {
+			print_usage();
+			throw std::invalid_argument("Unknown option " + arg);
+		}
+	}
+
+	if (options.pagerank_solver != "power" && options.pagerank_solver != "push" && options.pagerank_solver != "lumped" && options.pagerank_solver != "scc")
+		throw std::invalid_argument("Unknown PageRank solver " + options.pagerank_solver);
+	if (options.pagerank_solver != "power" && (options.fused || options.workers > 0 || options.checkpoint_every > 0 || options.resume || options.seed))
+		throw std::invalid_argument("The " + options.pagerank_solver + " solver cannot be used with --fused, --workers or checkpoints");
+	if (options.hits_solver != "power" && options.hits_solver != "lanczos") throw std::invalid_argument("Unknown HITS solver " + options.hits_solver);
+	if (options.hits_rank == 0) throw std::invalid_argument("--hits-rank must be at least 1");
+	if (options.fused && (options.hits_solver != "power" || options.checkpoint_every > 0 || options.resume || options.seed))
+		throw std::invalid_argument("--fused cannot be used with the lanczos solver or with checkpoints");
+	if (options.fused && options.workers > 0) throw std::invalid_argument("--fused and --workers cannot be used together");
+	if (options.concurrent && options.workers > 0) throw std::invalid_argument("--concurrent and --workers cannot be used together");
+	if (options.blockrank && (options.pagerank_solver != "power" || options.fused || options.workers > 0 || options.checkpoint_every > 0 || options.resume || options.seed))
+		throw std::invalid_argument("--blockrank needs the power solver and cannot be used with --fused, --workers or checkpoints");
+	if (options.blockrank_size == 0) throw std::invalid_argument("--blockrank-size must be at least 1");
+	if (options.checkpoint_every > 0 || options.resume || options.seed) options.cache = false;
+	if (options.resume && options.seed) throw std::invalid_argument("--resume and --seed cannot be used together");
+
+	return options;
+}
+
+#endif
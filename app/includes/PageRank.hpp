@@ -1,20 +1,25 @@
 #include "Graph.hpp"
+#include "Compressed.hpp"
+#include "Checkpoint.hpp"
+#include "Partition.hpp"
 #include <cmath>
+#include <atomic>
 
 // Class that provides the implementation of the PageRank algorithm.
 class PageRank {
 	public: 
 		// PageRank constructor.
-		PageRank(std::vector<unsigned int> top_k, std::string ds_path, double t_prob) : t_prob(t_prob) {
+		// With out_links the matrix is stored by source, as needed by the push solver, instead of by destination.
+		PageRank(std::vector<unsigned int> top_k, std::string ds_path, double t_prob, bool out_links = false) : t_prob(t_prob), out_links(out_links) {
 			this->top_k = top_k;
 			this->graph = Graph(ds_path);
 			
-			for (unsigned int i = 0; i < this->graph.nodes; i++) this->PR_Prestige[i] = 1. / this->graph.nodes;
+			this->PR_Prestige.assign(this->graph.id_space(), 1. / this->graph.nodes);
 
 			// computing the dangling nodes vectors and cardinality map
 			this->set_card_map_and_dan_node();
 			
-			// computing the transpose matrix
+			// computing the transpose matrix, or the matrix of the out-links
 			this->set_T_matrix();
 		}
 
@@ -24,105 +29,109 @@ class PageRank {
 		// Vector that store the results for each top_k.
 		top_k_results PR_topk; 
 
-		// Unordered map that memorize the actual PageRank Prestige for each node.
-		std::unordered_map<unsigned int, double> PR_Prestige; 
+		// Vector that memorize the actual PageRank Prestige for each node (indexed by node ID - min_node).
+		std::vector<double> PR_Prestige;
 
 		// Number of steps.
 		unsigned int steps = 0;
 
+		// Residual history, the L2 distance between two consecutive PageRank Prestige vectors.
+		std::vector<double> residuals;
+
 		// Elapsed time.
 		Duration elapsed;
+
+		// Communication of the partitioned run, no workers if the computation ran in this process.
+		PartitionTraffic traffic;
+
+		// Number of pushes, of edge updates and of frontier rounds of the push solver, and the bound on the L1 error of its result.
+		unsigned long pushes = 0;
+		unsigned long edge_updates = 0;
+		unsigned int rounds = 0;
+		double error_bound = -1.;
+
+		// Shape of the reduced problem: the non dangling nodes, the blocks they are solved in and the largest block (no blocks if the
+		// problem was not reduced), the rows decoded by the solver and the time taken by the reduction.
+		unsigned int reduced_nodes = 0;
+		unsigned int blocks = 0;
+		unsigned int largest_block = 0;
+		unsigned long edge_visits = 0;
+		Duration reduction_elapsed;
+
+		// BlockRank seeding: the number of blocks, the largest number of steps of a local PageRank, the steps of the block PageRank and the
+		// time taken to build the seed (no blocks if unused); the steps and the elapsed time of the same power iteration from the uniform vector,
+		// when it is run for comparison (no steps otherwise).
+		unsigned int seed_blocks = 0;
+		unsigned int seed_local_steps = 0;
+		unsigned int seed_block_steps = 0;
+		Duration seed_elapsed;
+		unsigned int uniform_steps = 0;
+		Duration uniform_elapsed;
 		
 		// Public functions declaration
 
 		void compute();
+		void compute_partitioned(unsigned int workers);
+		void compute_push(unsigned int workers, double tolerance);
+		void compute_reduced(bool components);
+		void compute_blockrank(unsigned int block_size, const std::string& hosts_path, unsigned int workers, bool compare);
 		void get_topk_results();
 		void print_topk_results();
 		void print_stats();
+		std::string get_stats();
+		std::vector<std::pair<unsigned int, double>> get_scores();
 		void free_T_matrix_memory();
+		void enable_checkpoint(std::string path, unsigned int every);
+		bool resume(std::string path);
+		bool seed(std::string path);
 
 	private:
 		Graph graph;
 		const double t_prob;
-		card_map cardinality_map;
+		const bool out_links;
 
-		// Vector that memorizes the ID of dangling nodes.
+		// Vector that memorizes 1/Oi for each node, 0 for the dangling ones.
+		std::vector<double> inv_out_degree;
+
+		// Vector that memorizes the index of dangling nodes.
 		std::vector<unsigned int> dangling_nodes; 
 
 		std::string algo_str = "PageRank Prestige"; 
 
-		// Pointer to the transpose matrix.
-		traspose_pair* pt_traspose; 
+		// Gap encoded transpose matrix, row j holds the sources of the in-links of node j.
+		CompressedMatrix T_matrix;
+
+		// Gap encoded adjacency matrix used instead of T_matrix by the push solver, row i holds the destinations of the out-links of node i.
+		CompressedMatrix out_matrix;
 
-		// Vector that stores the row pointer and the non empty row pointer.
-		std::vector<std::pair<unsigned int, unsigned int>> row_pointers; 
+		// Periodic writer of the PageRank state.
+		Checkpointer checkpointer;
 
 		// Private functions declaration
 
 		void set_card_map_and_dan_node();
-		void add_danglings(unsigned int start, unsigned int end);
 		void set_T_matrix();
-		bool converge(std::unordered_map<unsigned int, double> &temp_Pk);
+		bool converge(std::vector<double> &temp_Pk);
+		void set_components(std::vector<unsigned int>& order, std::vector<unsigned int>& block_offsets);
+		std::vector<unsigned int> set_blocks(unsigned int block_size, const std::string& hosts_path);
+		void seed_blockrank(unsigned int block_size, const std::string& hosts_path, unsigned int workers);
+		uint64_t state_fingerprint();
+		CheckpointState get_state();
 };
 
-// Function that adds a sequence of dangling nodes to the vector.
-void PageRank::add_danglings(unsigned int start, unsigned int end) {
-	for (unsigned int dan = start + 1; dan <= end - 1; dan++)
-		this->dangling_nodes.push_back(dan);
-}
-
-// Function that sets the cardinality map and the vector of dangling nodes.
+// Function that sets the inverse cardinality vector and the vector of dangling nodes.
 void PageRank::set_card_map_and_dan_node(){
-	unsigned int cardinality = 0;
-
-	// sorting the sequence of pair of points by the fist element by increasingly order
-	std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.edges, compareByFirstIncreasing);
-
-	unsigned int predecessor = this->graph.np_pointer[0].first;
-
-	for (unsigned int i = 0; i < this->graph.edges; i++) {
-		if (predecessor == this->graph.np_pointer[i].first) {
-			cardinality++;
-		} else {
-			this->cardinality_map[predecessor] = cardinality;
-				
-			if (this->graph.np_pointer[i].first - predecessor > 1)
-				this->add_danglings(predecessor, this->graph.np_pointer[i].first);
-			predecessor = this->graph.np_pointer[i].first;
-			cardinality = 1;
-		}
-	}
-
-	// in case there are remaning nodes to view after the max node, they are all dangling nodes
- 	if ((this->graph.max_node) - (this->graph.np_pointer[this->graph.edges - 1].first) > 0)
-		this->add_danglings(this->graph.np_pointer[this->graph.edges - 1].first, this->graph.max_node + 1);
-    
-	this->cardinality_map[predecessor] = cardinality;
+	set_inv_out_degree(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), this->inv_out_degree, this->dangling_nodes);
 }
 
 // Function that sets the transpose matrix.
 void PageRank::set_T_matrix() {
 
-	// sorting the sequence of pair of points by the second element by increasingly oder
-	std::stable_sort(this->graph.np_pointer, this->graph.np_pointer + this->graph.edges, compareBySecondIncreasing);
-
-	// allocating the right amount of memory
-    this->pt_traspose = (traspose_pair*)mmap(NULL, this->graph.edges * sizeof(traspose_pair), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
-	if (this->pt_traspose == MAP_FAILED)
-        throw std::runtime_error("Mapping pt_traspose Failed\n");
-
-	for (unsigned int j = 0; j < this->graph.edges; j++) {
-		if(j == 0 || this->graph.np_pointer[j].second != this->graph.np_pointer[j - 1].second)
-			
-			// adding the row pointer and the non empty row pointer in the vector of row pointers pairs
-			this->row_pointers.push_back(std::make_pair(j, this->graph.np_pointer[j].second - this->graph.min_node));
-
-														// 1/Oi														 col_index
-		this->pt_traspose[j] = traspose_pair(1. / this->cardinality_map[this->graph.np_pointer[j].first], this->graph.np_pointer[j].first);
-	}
-
-	// notifying the conclusion of the transpose matrix
-	this->row_pointers.push_back(std::make_pair(this->graph.edges, this->graph.edges)); 
+	// encoding the in-links (or the out-links) of each node as gaps, the 1/Oi values are kept once per node in inv_out_degree
+	if (this->out_links)
+		this->out_matrix.build(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), false);
+	else
+		this->T_matrix.build(this->graph.np_pointer, this->graph.edges, this->graph.min_node, this->graph.id_space(), true);
 
 	// freeing the Graph structure since now we will use only the transpose matrix
 	this->graph.freeMemory(); 
@@ -131,61 +140,590 @@ void PageRank::set_T_matrix() {
 // Function that computes the PageRank Prestige.
 void PageRank::compute() {
 
-	// initializing a temporary PageRank Prestige that will be empty after each do while iteration 
-	std::unordered_map<unsigned int, double> current_PR_Prestige;
+	// initializing a temporary PageRank Prestige that is fully overwritten at each do while iteration
+	std::vector<double> current_PR_Prestige(this->PR_Prestige.size(), 0.);
 
-	for (unsigned int i = 0; i < this->graph.nodes; i++) current_PR_Prestige[i] = 0.;
+	// P_k[i] / Oi, computed once per node so that each edge costs a single random access
+	std::vector<double> contribution(this->PR_Prestige.size(), 0.);
 
 	auto start = now();
+	bool running;
 
 	do {
 		double dangling_Pk = 0.;
 
 		// computing the PageRank of dangling nodes
-		for(int dan : this->dangling_nodes)
-			dangling_Pk += this->PR_Prestige[dan - this->graph.min_node] * (1. / this->graph.nodes);
+		for(unsigned int dan : this->dangling_nodes)
+			dangling_Pk += this->PR_Prestige[dan] * (1. / this->graph.nodes);
 
-		unsigned int row_ptr = 0;
-		unsigned int next_row_ptr = this->row_pointers[row_ptr + 1].first;  
+		for (unsigned int i = 0; i < contribution.size(); i++)
+			contribution[i] = this->PR_Prestige[i] * this->inv_out_degree[i];
 
-		// computing the A^t * P_k
-		for(unsigned int i = 0; i < this->graph.edges; i++) {
+		// computing the A^t * P_k, the rows of the transpose matrix are decoded on the fly
+		for (unsigned int row = 0; row < this->T_matrix.rows; row++) {
+			double sum = 0.;
+			this->T_matrix.for_each_in_row(row, [&](unsigned int col) { sum += contribution[col]; });
 			
-			// control if we can update the same node until change matrix row change
-			if(i == next_row_ptr){
-				row_ptr++;
-				next_row_ptr = this->row_pointers[row_ptr + 1].first;
-			}
+			// computing -------------------------> (d_Pk + A^t * P_k) * d 	+	(1 - d) / n
+			current_PR_Prestige[row] = ((dangling_Pk + sum) * this->t_prob) + (1 - this->t_prob) / this->graph.nodes;
+		}
+
+		this->steps++;
+		running = this->converge(current_PR_Prestige);
+
+		// snapshotting the state, the file is written by a background thread
+		if (running && this->checkpointer.due(this->steps))
+			this->checkpointer.save_async(this->get_state());
+	} while(running);
+	this->elapsed = now() - start;
+
+	// the final state is always saved, so that it can seed new runs
+	if (this->checkpointer.enabled())
+		this->checkpointer.save(this->get_state());
+}
+
+// Commands of the partitioned PageRank.
+const unsigned int PR_TRAFFIC = 1;
+const unsigned int PR_CONTRIBUTE = 2;
+const unsigned int PR_STEP = 3;
 
-			// here is done the actual matrix moltiplication between the transpose matrix (#edges x #edges) times the PR column vector (#edges x 1)
-			// so the summation between all the moltiplication of the elements of a given row and the element of the column vector
-			current_PR_Prestige[this->row_pointers[row_ptr].second] += this->pt_traspose[i].first * this->PR_Prestige[this->pt_traspose[i].second - this->graph.min_node];
+// Function that computes the PageRank Prestige with a group of worker processes, each one owning a contiguous slice of the rows of
+// the transpose matrix. The vectors live in shared memory: a worker writes only its slice and reads the contributions of the other
+// slices it needs (the remote entries), while the coordinator reduces the dangling PageRank and the residual of each step.
+void PageRank::compute_partitioned(unsigned int workers) {
+	const unsigned int size = this->PR_Prestige.size();
+	std::vector<unsigned int> bounds = partition_rows({&this->T_matrix}, workers);
+
+	double* current = shared_array(size);
+	double* next = shared_array(size);
+	double* contribution = shared_array(size);
+	std::copy(this->PR_Prestige.begin(), this->PR_Prestige.end(), current);
+
+	auto start = now();
+
+	WorkerGroup group(workers, [&](unsigned int w, const PartitionMessage& message) {
+		PartitionMessage reply;
+		reply.command = message.command;
+		const unsigned int lo = bounds[w], hi = bounds[w + 1];
+
+		if (message.command == PR_TRAFFIC)
+			slice_traffic(this->T_matrix, lo, hi, reply.values[0], reply.values[1]);
+		else if (message.command == PR_CONTRIBUTE) {
+			// P_k[i] / Oi of the slice, and the PageRank of its dangling nodes
+			for (unsigned int i = lo; i < hi; i++) {
+				contribution[i] = current[i] * this->inv_out_degree[i];
+				if (this->inv_out_degree[i] == 0.) reply.values[0] += current[i];
+			}
+		}
+		else if (message.command == PR_STEP) {
+			const double dangling_Pk = message.values[0];
+			for (unsigned int row = lo; row < hi; row++) {
+				double sum = 0.;
+				this->T_matrix.for_each_in_row(row, [&](unsigned int col) { sum += contribution[col]; });
+				next[row] = ((dangling_Pk + sum) * this->t_prob) + (1 - this->t_prob) / this->graph.nodes;
+				reply.values[0] += std::pow(std::abs(current[row] - next[row]), 2.);
+			}
+			std::swap(current, next);
 		}
+		return reply;
+	});
+
+	this->traffic = PartitionTraffic();
+	this->traffic.workers = workers;
+	PartitionMessage message;
+	message.command = PR_TRAFFIC;
+	for (const PartitionMessage& reply : group.broadcast(message)) {
+		this->traffic.cut_edges += reply.values[0];
+		this->traffic.remote_entries += reply.values[1];
+	}
+
+	bool running;
+	do {
+		double dangling_Pk = 0.;
+		message.command = PR_CONTRIBUTE;
+		for (const PartitionMessage& reply : group.broadcast(message))
+			dangling_Pk += reply.values[0];
 
-		// computing -------------------------> (d_Pk + A^t * P_k) * d 						 +				 (1 - d) / n
-		for (unsigned int i = 0; i < current_PR_Prestige.size(); i++)	
-			current_PR_Prestige[i] = ((dangling_Pk + current_PR_Prestige[i]) * this->t_prob) + (1 - this->t_prob) / this->graph.nodes;
+		double distance = 0.;
+		message.command = PR_STEP;
+		message.values[0] = dangling_Pk / this->graph.nodes;
+		for (const PartitionMessage& reply : group.broadcast(message))
+			distance += reply.values[0];
+		std::swap(current, next);
 
 		this->steps++;
-	} while(this->converge(current_PR_Prestige)); 
+		this->traffic.steps++;
+		this->residuals.push_back(std::sqrt(distance));
+		running = std::sqrt(distance) > std::pow(10, -10);
+
+		// snapshotting the state, the file is written by a background thread
+		if (running && this->checkpointer.due(this->steps)) {
+			std::copy(current, current + size, this->PR_Prestige.begin());
+			this->checkpointer.save_async(this->get_state());
+		}
+	} while (running);
+
+	group.stop();
+	this->traffic.control_bytes = group.control_bytes;
+	this->elapsed = now() - start;
+
+	std::copy(current, current + size, this->PR_Prestige.begin());
+	free_shared_array(current, size);
+	free_shared_array(next, size);
+	free_shared_array(contribution, size);
+
+	// the final state is always saved, so that it can seed new runs
+	if (this->checkpointer.enabled())
+		this->checkpointer.save(this->get_state());
+}
+
+// Number of nodes taken at once by a thread of the push solver.
+const size_t PUSH_CHUNK = 256;
+
+// Function that computes the PageRank Prestige with the residual push method. Each node keeps an estimate x and a residual r,
+// starting from x = 0 and r = (1 - d) / n; pushing a node moves its residual into x and spreads d * r / Oi to the residuals of its
+// out-links. Only the nodes whose residual is above the threshold are pushed, in rounds: the threads take chunks of the frontier
+// from an atomic counter, the residuals are accumulated with atomic additions, and a node enters the next frontier when its
+// residual crosses the threshold. The dangling nodes only keep their mass, the dangling PageRank spread by compute() is put back
+// at the end with a single scale factor. Since x + (I - d A^t)^-1 r is the exact solution, the L1 error of x is at most R / (1 - d),
+// where R is the total residual: the nodes are pushed until this bound, scaled as x, is below the tolerance.
+void PageRank::compute_push(unsigned int workers, double tolerance) {
+	if (!this->out_links)
+		throw std::runtime_error("The push solver needs the matrix of the out-links\n");
+
+	const unsigned int size = this->PR_Prestige.size();
+	const double d = this->t_prob;
+	double threshold = tolerance * (1 - d) / size;
+
+	std::vector<double> x(size, 0.);
+	std::vector<std::atomic<double>> residual(size);
+	for (unsigned int i = 0; i < size; i++) residual[i] = (1 - d) / this->graph.nodes;
+
+	std::vector<unsigned int> frontier;
+	std::vector<std::vector<unsigned int>> next_frontiers(workers);
+	std::vector<unsigned long> pushes(workers, 0), edge_updates(workers, 0);
+
+	auto start = now();
+
+	// the bound is known only at the end, since the dangling PageRank scales it: if it is above the tolerance
+	// the threshold is lowered and the nodes above the new threshold are pushed again
+	while (true) {
+		for (unsigned int i = 0; i < size; i++)
+			if (residual[i] > threshold) frontier.push_back(i);
+
+		while (!frontier.empty()) {
+			std::atomic<size_t> next_chunk(0);
+
+			parallel_run(workers, [&](unsigned int w) {
+				size_t begin;
+				while ((begin = next_chunk.fetch_add(PUSH_CHUNK)) < frontier.size()) {
+					size_t end = std::min(begin + PUSH_CHUNK, frontier.size());
+					for (size_t i = begin; i < end; i++) {
+						// a node is in the frontier once, so its x is written by a single thread
+						unsigned int u = frontier[i];
+						double r = residual[u].exchange(0.);
+						x[u] += r;
+						pushes[w]++;
+
+						if (this->inv_out_degree[u] == 0.) continue;
+						double share = d * r * this->inv_out_degree[u];
+						this->out_matrix.for_each_in_row(u, [&](unsigned int v) {
+							double before = residual[v].fetch_add(share);
+							if (before <= threshold && before + share > threshold) next_frontiers[w].push_back(v);
+							edge_updates[w]++;
+						});
+					}
+				}
+			});
+
+			frontier.clear();
+			for (std::vector<unsigned int>& next : next_frontiers) {
+				frontier.insert(frontier.end(), next.begin(), next.end());
+				next.clear();
+			}
+			this->rounds++;
+		}
+
+		// x solves x = d A^t x + (1 - d) / n without the dangling PageRank; the solution of compute() is alpha * x, where
+		// alpha * (1 - d - d * D) = 1 - d and D is the estimate of the dangling nodes
+		double R = 0., D = 0., total = 0.;
+		for (unsigned int i = 0; i < size; i++) {
+			R += residual[i];
+			total += x[i];
+			if (this->inv_out_degree[i] == 0.) D += x[i];
+		}
+		double alpha = (1 - d) / (1 - d - d * D);
+
+		// the exact D is at most D + R / (1 - d), which bounds the error of alpha too
+		double denominator = 1 - d - d * (D + R / (1 - d));
+		double alpha_max = (1 - d) / denominator;
+		this->error_bound = denominator > 0. ? alpha_max * R / (1 - d) + (alpha_max - alpha) * total : INFINITY;
+
+		if (this->error_bound <= tolerance) {
+			for (unsigned int i = 0; i < size; i++)
+				this->PR_Prestige[i] = alpha * x[i];
+			break;
+		}
+		threshold *= std::isfinite(this->error_bound) ? 0.9 * tolerance / this->error_bound : 0.1;
+	}
+
+	this->pushes = std::accumulate(pushes.begin(), pushes.end(), 0ul);
+	this->edge_updates = std::accumulate(edge_updates.begin(), edge_updates.end(), 0ul);
+
+	// a round touches only the frontier, so the steps are the power iteration steps that read as many edges as the pushes
+	this->steps = std::ceil((double)this->edge_updates / std::max(this->out_matrix.nnz, 1u));
+	this->elapsed = now() - start;
+}
+
+// Function that splits the non dangling nodes in the strongly connected components of the graph they induce, with an iterative Tarjan
+// visit of the in-links. A component is closed after all the components it reaches and, following the in-links, these are the components
+// that link to it: the components come out in topological order, the upstream ones first. The nodes are appended to order component after
+// component, block_offsets holds the first position of each component and the end of the last one.
+void PageRank::set_components(std::vector<unsigned int>& order, std::vector<unsigned int>& block_offsets) {
+	const unsigned int size = this->PR_Prestige.size();
+	std::vector<unsigned int> index(size, UINT_MAX), low(size, 0);
+	std::vector<bool> on_stack(size, false);
+	std::vector<unsigned int> stack;
+	std::vector<std::pair<unsigned int, RowCursor>> visit;
+	unsigned int counter = 0;
+
+	auto open = [&](unsigned int node) {
+		index[node] = low[node] = counter++;
+		stack.push_back(node);
+		on_stack[node] = true;
+		visit.push_back(std::make_pair(node, this->T_matrix.cursor(node)));
+	};
+
+	block_offsets.assign(1, 0);
+	for (unsigned int root = 0; root < size; root++) {
+		// the sources of the in-links have out-links, so the visit never reaches a dangling node
+		if (this->inv_out_degree[root] == 0. || index[root] != UINT_MAX) continue;
+
+		open(root);
+		while (!visit.empty()) {
+			unsigned int node = visit.back().first;
+			RowCursor& cursor = visit.back().second;
+			if (cursor.next()) {
+				if (index[cursor.col] == UINT_MAX)
+					open(cursor.col);
+				else if (on_stack[cursor.col])
+					low[node] = std::min(low[node], index[cursor.col]);
+				continue;
+			}
+
+			visit.pop_back();
+			if (!visit.empty())
+				low[visit.back().first] = std::min(low[visit.back().first], low[node]);
+
+			if (low[node] == index[node]) {
+				// closing the component of node
+				unsigned int member;
+				do {
+					member = stack.back();
+					stack.pop_back();
+					on_stack[member] = false;
+					order.push_back(member);
+				} while (member != node);
+				block_offsets.push_back(order.size());
+			}
+		}
+	}
+}
+
+// Function that computes the PageRank Prestige on the reduced problem. The dangling nodes are lumped (Lee, Golub and Zenios): the PageRank
+// is c * y, where y solves y = d * A^t * (y / O) + 1 on the non dangling nodes only, the y of a dangling node is then computed with one pass
+// over its in-links and c = (1 - d) / (n - d * Y_D) follows from the sum Y_D of the dangling y. With components the non dangling nodes are
+// also split in strongly connected components, solved one after the other in topological order: a single node is solved in closed form
+// and a larger component is iterated until its own y converges, reading the final y of the components upstream.
+void PageRank::compute_reduced(bool components) {
+	const unsigned int size = this->PR_Prestige.size();
+	const double d = this->t_prob;
+
+	auto start = now();
+
+	// the non dangling nodes in blocks, a single one without components
+	std::vector<unsigned int> order, block_offsets;
+	if (components)
+		this->set_components(order, block_offsets);
+	else {
+		for (unsigned int i = 0; i < size; i++)
+			if (this->inv_out_degree[i] != 0.) order.push_back(i);
+		block_offsets = {0, (unsigned int)order.size()};
+	}
+	this->reduced_nodes = order.size();
+	this->blocks = block_offsets.size() - 1;
+	for (unsigned int b = 0; b < this->blocks; b++)
+		this->largest_block = std::max(this->largest_block, block_offsets[b + 1] - block_offsets[b]);
+
+	// relabeling the nodes: the non dangling ones take the positions [0, reduced_nodes) in block order, the dangling ones follow
+	std::vector<unsigned int> position(size);
+	for (unsigned int dan : this->dangling_nodes) order.push_back(dan);
+	for (unsigned int p = 0; p < size; p++) position[order[p]] = p;
+
+	// encoding again the in-links with the new labels, so that the rows of a block are contiguous and the vectors have one entry per position
+	const unsigned int nnz = this->T_matrix.nnz;
+	nodes_pair* pairs = (nodes_pair*)mmap(NULL, std::max(nnz, 1u) * sizeof(nodes_pair), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
+	if (pairs == MAP_FAILED)
+		throw std::runtime_error("Mapping pairs Failed\n");
+	size_t e = 0;
+	for (unsigned int row = 0; row < size; row++)
+		this->T_matrix.for_each_in_row(row, [&](unsigned int col) { pairs[e++] = nodes_pair(position[col], position[row]); });
+	this->T_matrix.freeMemory();
+	this->T_matrix = CompressedMatrix();
+	this->T_matrix.build(pairs, nnz, 0, size, true);
+	if (munmap(pairs, std::max(nnz, 1u) * sizeof(nodes_pair)) != 0)
+		throw std::runtime_error("Free memory failed\n");
+
+	std::vector<double> inv_out(this->reduced_nodes);
+	for (unsigned int p = 0; p < this->reduced_nodes; p++) inv_out[p] = this->inv_out_degree[order[p]];
+	this->reduction_elapsed = now() - start;
+
+	// y of all the positions, starting from 1 (the dangling ones are computed at the end), and next and y / O of the non dangling ones
+	std::vector<double> y(size, 1.), next(this->reduced_nodes), contribution(inv_out);
+
+	// summing y over the m positions gives Y = m + d * Y_N, since a non dangling node spreads its whole y over its out-links: Y_D = m - (1 - d) * Y_N.
+	// The iterates grow monotonically from y = 1, so the actual Y_N is a lower bound of the final one and the c computed from m - (1 - d) * Y_N is an
+	// upper bound that tightens as y converges. The map y -> 1 + d * A^t * (y / O) shrinks L1 distances by d, so the L1 error of a block is at most
+	// d / (1 - d) times the L1 distance of two consecutive y; the error left in a block reaches the blocks downstream shrunk by d at each link, so the
+	// total L1 error of the PageRank is at most 1 / (1 - d) times the sum of the errors of the blocks, and each block gets (1 - d) times its share of
+	// the tolerance, by its size. If the node ID gaps are so many that the bound is not finite, c >= (1 - d) / n is used instead and the tolerance
+	// is not guaranteed
+	double non_dangling_y = this->reduced_nodes;
+	auto c_bound = [&]() {
+		double denominator = this->graph.nodes - d * (size - (1 - d) * non_dangling_y);
+		return denominator > 0. ? (1 - d) / denominator : (1 - d) / this->graph.nodes;
+	};
+	const double tolerance = std::pow(10, -8);
+
+	for (unsigned int b = 0; b < this->blocks; b++) {
+		const unsigned int lo = block_offsets[b], hi = block_offsets[b + 1];
+
+		if (hi - lo == 1) {
+			// a single node: y = 1 + d * (upstream + self * y / O), solved for y
+			double upstream = 0., self = 0.;
+			this->T_matrix.for_each_in_row(lo, [&](unsigned int col) {
+				if (col == lo) self++;
+				else upstream += contribution[col];
+				this->edge_visits++;
+			});
+			y[lo] = (1 + d * upstream) / (1 - d * self * inv_out[lo]);
+			non_dangling_y += y[lo] - 1;
+			contribution[lo] = y[lo] * inv_out[lo];
+			continue;
+		}
+
+		const double block_tolerance = (1 - d) * tolerance * (hi - lo) / this->reduced_nodes;
+		double distance;
+		do {
+			for (unsigned int row = lo; row < hi; row++) {
+				double sum = 0.;
+				this->T_matrix.for_each_in_row(row, [&](unsigned int col) {
+					sum += contribution[col];
+					this->edge_visits++;
+				});
+				next[row] = 1 + d * sum;
+			}
+
+			distance = 0.;
+			for (unsigned int row = lo; row < hi; row++) {
+				distance += std::abs(next[row] - y[row]);
+				non_dangling_y += next[row] - y[row];
+				y[row] = next[row];
+				contribution[row] = y[row] * inv_out[row];
+			}
+		} while (c_bound() * d / (1 - d) * distance > block_tolerance);
+	}
+
+	// recovering the dangling nodes, whose in-links all come from non dangling ones
+	double dangling_y = 0.;
+	for (unsigned int p = this->reduced_nodes; p < size; p++) {
+		double sum = 0.;
+		this->T_matrix.for_each_in_row(p, [&](unsigned int col) {
+			sum += contribution[col];
+			this->edge_visits++;
+		});
+		y[p] = 1 + d * sum;
+		dangling_y += y[p];
+	}
+
+	const double c = (1 - d) / (this->graph.nodes - d * dangling_y);
+	for (unsigned int p = 0; p < size; p++)
+		this->PR_Prestige[order[p]] = c * y[p];
+
+	// the blocks take different numbers of iterations, so the steps are the power iteration steps that read as many edges
+	this->steps = std::ceil((double)this->edge_visits / std::max(nnz, 1u));
+
 	this->elapsed = now() - start;
 }
 
+// Function that assigns each node to a block and returns the block of each node. The blocks are the hosts of a mapping file, with one
+// "<node ID> <host>" line for each node, or contiguous ranges of block_size node IDs for the nodes the file does not list (all of them
+// without a file). The empty blocks are dropped.
+std::vector<unsigned int> PageRank::set_blocks(unsigned int block_size, const std::string& hosts_path) {
+	const unsigned int size = this->PR_Prestige.size();
+	std::vector<unsigned int> block(size, UINT_MAX);
+	unsigned int hosts = 0;
+
+	if (!hosts_path.empty()) {
+		std::ifstream file = readDataset(hosts_path);
+		std::unordered_map<std::string, unsigned int> host_ids;
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.empty() || line[0] == '#') continue;
+			unsigned int node = 0;
+			auto parsed = std::from_chars(line.data(), line.data() + line.size(), node);
+			if (parsed.ec == std::errc::result_out_of_range) continue;
+			size_t host_begin = parsed.ec == std::errc() ? line.find_first_not_of(" \t", parsed.ptr - line.data()) : std::string::npos;
+			if (host_begin == std::string::npos)
+				throw std::runtime_error("Invalid line in " + hosts_path + ": " + line + "\n");
+			if (node < (unsigned int)this->graph.min_node || node > (unsigned int)this->graph.max_node) continue;
+
+			size_t host_end = line.find_first_of(" \t\r", host_begin);
+			auto found = host_ids.emplace(line.substr(host_begin, host_end - host_begin), host_ids.size()).first;
+			block[node - this->graph.min_node] = found->second;
+		}
+		hosts = host_ids.size();
+	}
+
+	for (unsigned int i = 0; i < size; i++)
+		if (block[i] == UINT_MAX) block[i] = hosts + i / block_size;
+
+	// numbering the non empty blocks
+	std::vector<unsigned int> ids(*std::max_element(block.begin(), block.end()) + 1, UINT_MAX);
+	this->seed_blocks = 0;
+	for (unsigned int i = 0; i < size; i++) {
+		if (ids[block[i]] == UINT_MAX) ids[block[i]] = this->seed_blocks++;
+		block[i] = ids[block[i]];
+	}
+	return block;
+}
+
+// Function that sets the starting vector with BlockRank (Kamvar, Haveliwala, Manning and Golub). The PageRank of each block is computed
+// on its own links only, the blocks in parallel; the blocks are then ranked by a PageRank on the graph of the blocks, where the weight of
+// a link between two blocks is the local PageRank that flows along the links between their nodes. The starting PageRank of a node is its
+// local PageRank times the PageRank of its block. The teleporting and the dangling nodes are spread by block size, as in the global PageRank.
+void PageRank::seed_blockrank(unsigned int block_size, const std::string& hosts_path, unsigned int workers) {
+	const unsigned int size = this->PR_Prestige.size();
+	const double d = this->t_prob;
+
+	auto start = now();
+	std::vector<unsigned int> block = this->set_blocks(block_size, hosts_path);
+	const unsigned int blocks = this->seed_blocks;
+
+	// the nodes of each block are contiguous in order, position is the index of a node in order
+	std::vector<unsigned int> offsets(blocks + 1, 0), order(size), position(size);
+	for (unsigned int i = 0; i < size; i++) offsets[block[i] + 1]++;
+	for (unsigned int b = 0; b < blocks; b++) offsets[b + 1] += offsets[b];
+	std::vector<unsigned int> next_slot(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0; i < size; i++) {
+		position[i] = next_slot[block[i]]++;
+		order[position[i]] = i;
+	}
+
+	// 1/Oi counting only the links inside the block of i, 0 if there are none
+	std::vector<double> inv_local_out(size, 0.);
+	for (unsigned int row = 0; row < size; row++)
+		this->T_matrix.for_each_in_row(row, [&](unsigned int col) { if (block[col] == block[row]) inv_local_out[col]++; });
+	for (double& value : inv_local_out) value = value > 0. ? 1. / value : 0.;
+
+	// local PageRank of each block, indexed by position, each block summing to 1
+	std::vector<double> local(size), next(size);
+	std::vector<unsigned int> local_steps(workers, 0);
+	std::atomic<unsigned int> next_block(0);
+	parallel_run(workers, [&](unsigned int w) {
+		unsigned int b;
+		while ((b = next_block.fetch_add(1)) < blocks) {
+			const unsigned int lo = offsets[b], hi = offsets[b + 1], nodes = hi - lo;
+			for (unsigned int p = lo; p < hi; p++) local[p] = 1. / nodes;
+
+			for (unsigned int step = 1; step <= 100; step++) {
+				double dangling = 0.;
+				for (unsigned int p = lo; p < hi; p++)
+					if (inv_local_out[order[p]] == 0.) dangling += local[p];
+
+				double distance = 0.;
+				for (unsigned int p = lo; p < hi; p++) {
+					double sum = 0.;
+					this->T_matrix.for_each_in_row(order[p], [&](unsigned int col) {
+						if (block[col] == b) sum += local[position[col]] * inv_local_out[col];
+					});
+					next[p] = d * (sum + dangling / nodes) + (1 - d) / nodes;
+					distance += std::abs(next[p] - local[p]);
+				}
+				std::copy(next.begin() + lo, next.begin() + hi, local.begin() + lo);
+				local_steps[w] = std::max(local_steps[w], step);
+
+				// the local vectors only need to be roughly right, the global iteration corrects them
+				if (distance < std::pow(10, -6)) break;
+			}
+		}
+	});
+	this->seed_local_steps = *std::max_element(local_steps.begin(), local_steps.end());
+
+	// graph of the blocks: the weight of I -> J is the local PageRank flowing from the nodes of I to the nodes of J
+	std::unordered_map<uint64_t, double> links;
+	std::vector<double> out_weight(blocks, 0.);
+	for (unsigned int row = 0; row < size; row++)
+		this->T_matrix.for_each_in_row(row, [&](unsigned int col) {
+			double weight = local[position[col]] * this->inv_out_degree[col];
+			links[(uint64_t)block[col] << 32 | block[row]] += weight;
+			out_weight[block[col]] += weight;
+		});
+
+	// block PageRank: the teleporting and the weight of the dangling nodes go to each block in proportion to its size
+	std::vector<double> rank(blocks), next_rank(blocks);
+	for (unsigned int b = 0; b < blocks; b++) rank[b] = (double)(offsets[b + 1] - offsets[b]) / this->graph.nodes;
+	for (this->seed_block_steps = 1; this->seed_block_steps <= 1000; this->seed_block_steps++) {
+		double dangling = 0.;
+		for (unsigned int b = 0; b < blocks; b++) dangling += rank[b] * (1 - out_weight[b]);
+
+		for (unsigned int b = 0; b < blocks; b++)
+			next_rank[b] = (offsets[b + 1] - offsets[b]) * (d * dangling + 1 - d) / this->graph.nodes;
+		for (const auto& link : links)
+			next_rank[link.first & 0xFFFFFFFF] += d * rank[link.first >> 32] * link.second;
+
+		double distance = 0.;
+		for (unsigned int b = 0; b < blocks; b++) distance += std::abs(next_rank[b] - rank[b]);
+		std::swap(rank, next_rank);
+		if (distance < std::pow(10, -12)) break;
+	}
+
+	for (unsigned int i = 0; i < size; i++)
+		this->PR_Prestige[i] = rank[block[i]] * local[position[i]];
+	this->seed_elapsed = now() - start;
+}
+
+// Function that computes the PageRank Prestige with the power iteration started from the BlockRank vector, the elapsed time includes the
+// seeding. With compare the same iteration is first run from the uniform vector, so that the steps and the time saved are reported.
+void PageRank::compute_blockrank(unsigned int block_size, const std::string& hosts_path, unsigned int workers, bool compare) {
+	if (compare) {
+		std::vector<double> uniform = this->PR_Prestige;
+		this->compute();
+		this->uniform_steps = this->steps;
+		this->uniform_elapsed = this->elapsed;
+
+		this->PR_Prestige = uniform;
+		this->steps = 0;
+		this->residuals.clear();
+	}
+
+	this->seed_blockrank(block_size, hosts_path, workers);
+	this->compute();
+	this->elapsed += this->seed_elapsed;
+}
+
 // Function that verifies if we reach the point of convergence.
-bool PageRank::converge(std::unordered_map<unsigned int, double> &temp_Pk) {
+bool PageRank::converge(std::vector<double> &temp_Pk) {
 	double distance = 0.;
 
 	// getting the total distance of absolute difference between the actual PR Prestige vector and the early computed one
 	for (unsigned int i = 0; i < temp_Pk.size(); i++) 
 		distance += std::pow(std::abs(this->PR_Prestige[i] - temp_Pk[i]), 2.);
 
-	// update
-	this->PR_Prestige = temp_Pk; 
+	this->residuals.push_back(std::sqrt(distance));
 
-	// emptying the temporary vector
-	temp_Pk.clear();
-
-	for (unsigned int i = 0; i < this->graph.nodes; i++) temp_Pk[i] = 0.;
+	// update, the old vector is reused as the next temporary one
+	std::swap(this->PR_Prestige, temp_Pk);
 
 	// verify the convergence
 	return std::sqrt(distance) > std::pow(10, -10); 
@@ -193,8 +731,59 @@ bool PageRank::converge(std::unordered_map<unsigned int, double> &temp_Pk) {
 
 // Function that frees the permanent memory regarding the transpose matrix.
 void PageRank::free_T_matrix_memory(){
-	if (munmap(this->pt_traspose, this->graph.edges) != 0)
-    	throw std::runtime_error("Free memory failed\n");
+	if (this->out_links)
+		this->out_matrix.freeMemory();
+	else
+		this->T_matrix.freeMemory();
+}
+
+// Function that returns the fingerprint of the graph combined with the teleporting probability.
+uint64_t PageRank::state_fingerprint() {
+	return fnv1a(&this->t_prob, sizeof(this->t_prob), this->graph.fingerprint);
+}
+
+// Function that returns a snapshot of the actual state of the computation.
+CheckpointState PageRank::get_state() {
+	CheckpointState state;
+	state.algo = "PageRank";
+	state.fingerprint = this->state_fingerprint();
+	state.steps = this->steps;
+	state.vectors = {this->PR_Prestige};
+	state.residuals = {this->residuals};
+	return state;
+}
+
+// Function that enables the checkpointing of the state every given number of steps.
+void PageRank::enable_checkpoint(std::string path, unsigned int every) {
+	this->checkpointer = Checkpointer(path, every);
+}
+
+// Function that restores the state saved in a checkpoint, it returns false if there is no checkpoint.
+bool PageRank::resume(std::string path) {
+	CheckpointState state;
+	if (!Checkpointer::load(path, state))
+		return false;
+
+	if (state.algo != "PageRank" || state.fingerprint != this->state_fingerprint() || state.vectors.size() != 1 || state.vectors[0].size() != this->PR_Prestige.size())
+		throw std::runtime_error("Checkpoint does not match the graph\n");
+
+	this->PR_Prestige = state.vectors[0];
+	this->steps = state.steps;
+	this->residuals = state.residuals.empty() ? std::vector<double>() : state.residuals[0];
+	return true;
+}
+
+// Function that uses the PageRank Prestige saved in a checkpoint as starting vector of a new run, it returns false if there is no checkpoint.
+bool PageRank::seed(std::string path) {
+	CheckpointState state;
+	if (!Checkpointer::load(path, state))
+		return false;
+
+	if (state.algo != "PageRank" || state.vectors.size() != 1 || state.vectors[0].size() != this->PR_Prestige.size())
+		throw std::runtime_error("Checkpoint does not match the graph\n");
+
+	this->PR_Prestige = state.vectors[0];
+	return true;
 }
 
 // Function that computes the top_k nodes based on the PageRank Prestige.
@@ -207,7 +796,36 @@ void PageRank::print_topk_results() {
 	this->graph.print_algo_topk_results(this->PR_topk, this->algo_str);
 }
 
+// Function that returns the (node ID, PageRank Prestige) pairs of all the nodes.
+std::vector<std::pair<unsigned int, double>> PageRank::get_scores() {
+	return this->graph.get_scores(this->PR_Prestige);
+}
+
+// Function that returns the elapsed time and the number of steps taken.
+std::string PageRank::get_stats() {
+	std::ostringstream stats;
+	stats << "Elapsed: " << this->elapsed.count() << " ms \t Steps: "<< this->steps << std::endl;
+	stats << "Compressed matrix: " << (this->out_links ? this->out_matrix : this->T_matrix).bytes_per_edge() << " bytes per edge" << std::endl;
+	if (this->traffic.workers > 0) stats << this->traffic.str(this->T_matrix.nnz);
+	if (this->error_bound >= 0.)
+		stats << "Rounds: " << this->rounds << " \t Pushes: " << this->pushes << " \t Edge updates: " << this->edge_updates << " ("
+			  << (double)this->edge_updates / std::max(this->out_matrix.nnz, 1u) << " steps of the power iteration)"
+			  << " \t L1 error bound: " << this->error_bound << std::endl;
+	if (this->seed_blocks > 0)
+		stats << "BlockRank blocks: " << this->seed_blocks << " \t Local steps: " << this->seed_local_steps << " \t Block steps: " << this->seed_block_steps
+			  << " \t Seed: " << this->seed_elapsed.count() << " ms" << std::endl;
+	if (this->uniform_steps > 0)
+		stats << "Uniform start: " << this->uniform_elapsed.count() << " ms, " << this->uniform_steps << " steps"
+			  << " \t Saved: " << (int)this->uniform_steps - (int)this->steps << " steps, " << (this->uniform_elapsed - this->elapsed).count() << " ms" << std::endl;
+	if (this->blocks > 0)
+		stats << "Non dangling nodes: " << this->reduced_nodes << " (" << 100. * this->reduced_nodes / std::max(this->T_matrix.rows, 1u) << "%)"
+			  << " \t Blocks: " << this->blocks << " \t Largest block: " << this->largest_block
+			  << " \t Edge visits: " << this->edge_visits << " (" << (double)this->edge_visits / std::max(this->T_matrix.nnz, 1u) << " steps of the power iteration)"
+			  << " \t Reduction: " << this->reduction_elapsed.count() << " ms" << std::endl;
+	return stats.str();
+}
+
 // Function that prints the elapsed time and the number of steps taken.
 void PageRank::print_stats() {
-	std::cout << "Elapsed: " << this->elapsed.count() << " ms \t Steps: "<< this->steps << std::endl;
+	std::cout << this->get_stats();
 }
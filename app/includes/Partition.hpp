@@ -0,0 +1,237 @@
+#ifndef _PARTITION_H
+#define _PARTITION_H
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sstream>
+#include "./Compressed.hpp"
+
+// Message exchanged between the coordinator and a worker process: a command and up to three values
+// (e.g. the dangling PageRank on the way out, the partial sums of a slice on the way back).
+struct PartitionMessage {
+	unsigned int command = 0;
+	double values[3] = {0., 0., 0.};
+};
+
+// Command that terminates a worker process.
+const unsigned int PARTITION_STOP = 0;
+
+// Structure that describes the communication of a partitioned run.
+// The cut is counted on all the matrices read by the run (L and L_t for HITS), the percentage is relative to their entries.
+struct PartitionTraffic {
+	// Number of worker processes.
+	unsigned int workers = 0;
+
+	// Number of edges whose source and destination are owned by different workers.
+	double cut_edges = 0.;
+
+	// Number of distinct score entries that each step a worker reads from the slices of the others.
+	double remote_entries = 0.;
+
+	// Bytes of the control messages exchanged with the coordinator.
+	size_t control_bytes = 0;
+
+	// Number of steps computed by the workers.
+	unsigned int steps = 0;
+
+	// Public functions declaration
+
+	std::string str(unsigned int edges) const;
+};
+
+// Function that returns the cut, the remote reads per step and the total exchanged volume.
+std::string PartitionTraffic::str(unsigned int edges) const {
+	std::ostringstream out;
+	out << "Workers: " << this->workers << " \t Cut edges: " << this->cut_edges << " (" << 100. * this->cut_edges / std::max(edges, 1u) << "%)"
+		<< " \t Remote entries per step: " << this->remote_entries
+		<< " \t Exchanged: " << (this->remote_entries * sizeof(double) * this->steps + this->control_bytes) / (1 << 20) << " MB" << std::endl;
+	return out.str();
+}
+
+// Function that splits the rows of one or more matrices with the same rows in contiguous slices with about the same decoding cost,
+// estimated as the number of encoded bytes plus the number of rows. The slice of worker w is [bounds[w], bounds[w + 1]).
+std::vector<unsigned int> partition_rows(const std::vector<const CompressedMatrix*>& matrices, unsigned int parts) {
+	unsigned int rows = matrices[0]->rows;
+	auto cost = [&](unsigned int row) {
+		size_t total = row;
+		for (const CompressedMatrix* matrix : matrices) total += matrix->row_offsets[row];
+		return total;
+	};
+
+	std::vector<unsigned int> bounds(parts + 1, rows);
+	bounds[0] = 0;
+	unsigned int row = 0;
+	for (unsigned int p = 1; p < parts; p++) {
+		size_t target = cost(rows) * p / parts;
+		while (row < rows && cost(row) < target) row++;
+		bounds[p] = row;
+	}
+	return bounds;
+}
+
+// Function that counts the edges of the rows [lo, hi) whose column is outside the slice, and the distinct columns outside the slice.
+void slice_traffic(const CompressedMatrix& matrix, unsigned int lo, unsigned int hi, double& cut_edges, double& remote_entries) {
+	std::vector<bool> seen(matrix.rows, false);
+	for (unsigned int row = lo; row < hi; row++) {
+		matrix.for_each_in_row(row, [&](unsigned int col) {
+			if (col >= lo && col < hi) return;
+			cut_edges++;
+			if (!seen[col]) {
+				seen[col] = true;
+				remote_entries++;
+			}
+		});
+	}
+}
+
+// Function that allocates an array of doubles shared with the worker processes forked afterwards.
+double* shared_array(size_t size) {
+	double* array = (double*)mmap(NULL, std::max<size_t>(size, 1) * sizeof(double), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 0, 0);
+	if (array == MAP_FAILED)
+		throw std::runtime_error("Mapping shared array Failed\n");
+	return array;
+}
+
+// Function that frees an array allocated by shared_array.
+void free_shared_array(double* array, size_t size) {
+	if (munmap(array, std::max<size_t>(size, 1) * sizeof(double)) != 0)
+		throw std::runtime_error("Free memory failed\n");
+}
+
+// Class that runs a group of local worker processes, each one connected to the coordinator by a Unix socket pair.
+// The coordinator broadcasts a command and collects one reply from each worker; the workers answer by calling the
+// handler in a loop until they receive PARTITION_STOP. The score vectors are exchanged through shared arrays.
+class WorkerGroup {
+	public:
+		// WorkerGroup constructor, it forks the workers.
+		WorkerGroup(unsigned int workers, std::function<PartitionMessage(unsigned int, const PartitionMessage&)> handler);
+
+		// WorkerGroup destructor, it terminates the workers that are still running (e.g. after an exception in the coordinator).
+		~WorkerGroup() {
+			this->stop();
+		}
+
+		WorkerGroup(const WorkerGroup&) = delete;
+		WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+		// Bytes of the control messages sent and received.
+		size_t control_bytes = 0;
+
+		// Public functions declaration
+
+		std::vector<PartitionMessage> broadcast(const PartitionMessage& message);
+		void stop();
+
+	private:
+		// Coordinator side of the socket pair of each worker.
+		std::vector<int> sockets;
+
+		// Process ID of each worker.
+		std::vector<pid_t> pids;
+
+		// Private functions declaration
+
+		static void send_message(int socket, const PartitionMessage& message);
+		static bool receive_message(int socket, PartitionMessage& message);
+};
+
+// Function that forks the workers, each one serving the commands of its socket with the handler.
+// If a worker cannot be started, the ones already running are terminated.
+WorkerGroup::WorkerGroup(unsigned int workers, std::function<PartitionMessage(unsigned int, const PartitionMessage&)> handler) {
+	for (unsigned int w = 0; w < workers; w++) {
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+			this->stop();
+			throw std::runtime_error("Socket pair creation failed\n");
+		}
+
+		pid_t pid = fork();
+		if (pid < 0) {
+			close(pair[0]);
+			close(pair[1]);
+			this->stop();
+			throw std::runtime_error("Fork failed\n");
+		}
+
+		if (pid == 0) {
+			// worker: the sockets of the previous workers belong to the coordinator only
+			for (int socket : this->sockets) close(socket);
+			close(pair[0]);
+
+			// _exit does not run the destructors and the stdio flushes of the coordinator, also when the handler throws:
+			// the coordinator sees the closed socket and reports the failure
+			try {
+				PartitionMessage message;
+				while (receive_message(pair[1], message) && message.command != PARTITION_STOP)
+					send_message(pair[1], handler(w, message));
+			} catch (...) {
+				_exit(1);
+			}
+
+			close(pair[1]);
+			_exit(0);
+		}
+
+		close(pair[1]);
+		this->sockets.push_back(pair[0]);
+		this->pids.push_back(pid);
+	}
+}
+
+// Function that sends a command to all the workers and returns their replies, in worker order.
+std::vector<PartitionMessage> WorkerGroup::broadcast(const PartitionMessage& message) {
+	for (int socket : this->sockets)
+		send_message(socket, message);
+
+	std::vector<PartitionMessage> replies(this->sockets.size());
+	for (unsigned int w = 0; w < this->sockets.size(); w++)
+		if (!receive_message(this->sockets[w], replies[w]))
+			throw std::runtime_error("Worker " + std::to_string(w) + " terminated\n");
+
+	this->control_bytes += 2 * this->sockets.size() * sizeof(PartitionMessage);
+	return replies;
+}
+
+// Function that terminates the workers and waits for them; a worker that already exited is only waited for.
+void WorkerGroup::stop() {
+	PartitionMessage message;
+	message.command = PARTITION_STOP;
+	for (int socket : this->sockets) {
+		try {
+			send_message(socket, message);
+		} catch (const std::runtime_error&) { }
+		close(socket);
+	}
+	for (pid_t pid : this->pids)
+		waitpid(pid, NULL, 0);
+
+	this->sockets.clear();
+	this->pids.clear();
+}
+
+// Function that writes a whole message on a socket; a closed peer is reported as an exception instead of a SIGPIPE.
+void WorkerGroup::send_message(int socket, const PartitionMessage& message) {
+	const char* data = (const char*)&message;
+	size_t written = 0;
+	while (written < sizeof(message)) {
+		ssize_t w = send(socket, data + written, sizeof(message) - written, MSG_NOSIGNAL);
+		if (w <= 0) throw std::runtime_error("Write failed\n");
+		written += w;
+	}
+}
+
+// Function that reads a whole message from a socket, it returns false if the other side closed it.
+bool WorkerGroup::receive_message(int socket, PartitionMessage& message) {
+	char* data = (char*)&message;
+	size_t received = 0;
+	while (received < sizeof(message)) {
+		ssize_t r = read(socket, data + received, sizeof(message) - received);
+		if (r <= 0) return false;
+		received += r;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef _RANK_STORE_H
+#define _RANK_STORE_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include "./Reporter.hpp"
+
+// Class that maps in memory a binary rank file written by write_rank_binary.
+class RankFile {
+	public:
+		// Default constructor.
+		RankFile() { };
+
+		// RankFile constructor.
+		RankFile(const std::string& path) {
+			this->map_file(path);
+		}
+
+		RankFile(const RankFile&) = delete;
+		RankFile& operator=(const RankFile&) = delete;
+
+		// RankFile destructor.
+		~RankFile() {
+			if (this->data != nullptr) munmap(this->data, this->size);
+		}
+
+		// Public functions declaration
+
+		uint32_t count() const;
+		const RankRecord* top() const;
+		const RankRecord* find(uint32_t node) const;
+		uint32_t position(uint32_t node) const;
+
+	private:
+		void* data = nullptr;
+		size_t size = 0;
+		const RankFileHeader* header = nullptr;
+		const RankRecord* records = nullptr;
+		const uint32_t* positions = nullptr;
+
+		// Private functions declaration
+
+		void map_file(const std::string& path);
+};
+
+// Function that maps the file and validates its layout.
+void RankFile::map_file(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("Could not open file " + path);
+
+	struct stat st;
+	fstat(fd, &st);
+	this->size = st.st_size;
+	if (this->size < sizeof(RankFileHeader)) {
+		close(fd);
+		throw std::runtime_error("Invalid rank file " + path);
+	}
+
+	this->data = mmap(NULL, this->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (this->data == MAP_FAILED) {
+		this->data = nullptr;
+		throw std::runtime_error("Mapping " + path + " Failed\n");
+	}
+
+	this->header = (const RankFileHeader*)this->data;
+	this->records = (const RankRecord*)(this->header + 1);
+	this->positions = (const uint32_t*)(this->records + this->header->count);
+
+	if (std::memcmp(this->header->magic, RankFileHeader().magic, 4) != 0 ||
+		this->size != sizeof(RankFileHeader) + this->header->count * sizeof(RankRecord) + (size_t)this->header->span * sizeof(uint32_t))
+		throw std::runtime_error("Invalid rank file " + path);
+
+	// the records are read in rank order, the positions randomly
+	madvise(this->data, this->size, MADV_WILLNEED);
+}
+
+// Function that returns the number of ranked nodes.
+uint32_t RankFile::count() const {
+	return this->header->count;
+}
+
+// Function that returns the records sorted by rank, the first k of them are the top-k nodes.
+const RankRecord* RankFile::top() const {
+	return this->records;
+}
+
+// Function that returns the 0-based position of a node in the ranking, RANK_MISSING if the node is not ranked.
+uint32_t RankFile::position(uint32_t node) const {
+	if (node < this->header->min_node || node - this->header->min_node >= this->header->span)
+		return RANK_MISSING;
+	return this->positions[node - this->header->min_node];
+}
+
+// Function that returns the record of a node, nullptr if the node is not ranked.
+const RankRecord* RankFile::find(uint32_t node) const {
+	uint32_t pos = this->position(node);
+	return pos == RANK_MISSING ? nullptr : this->records + pos;
+}
+
+// Class that serves the rankings of the four algorithms for one dataset.
+class RankStore {
+	public:
+		// RankStore constructor, it maps the .rank files written by the application for the given dataset.
+		RankStore(const std::string& result_dir, const std::string& ds) {
+			for (const std::string& algo : RankStore::algorithms())
+				this->files[algo] = std::make_unique<RankFile>(result_dir + "/" + ds + "." + algo + ".rank");
+		}
+
+		// Public functions declaration
+
+		static const std::vector<std::string>& algorithms();
+		const RankFile& get(const std::string& algo) const;
+		double jaccard(const std::string& algo1, const std::string& algo2, uint32_t k) const;
+		std::string execute(const std::string& query) const;
+
+	private:
+		std::map<std::string, std::unique_ptr<RankFile>> files;
+};
+
+// Function that returns the names of the served algorithms.
+const std::vector<std::string>& RankStore::algorithms() {
+	static const std::vector<std::string> names = {"indegree", "pagerank", "authority", "hub"};
+	return names;
+}
+
+// Function that returns the rank file of an algorithm.
+const RankFile& RankStore::get(const std::string& algo) const {
+	auto it = this->files.find(algo);
+	if (it == this->files.end())
+		throw std::invalid_argument("unknown algorithm " + algo);
+	return *it->second;
+}
+
+// Function that computes the Jaccard coefficient of the top-k nodes of two algorithms, in O(k) using the position table of the second one.
+double RankStore::jaccard(const std::string& algo1, const std::string& algo2, uint32_t k) const {
+	const RankFile& file1 = this->get(algo1);
+	const RankFile& file2 = this->get(algo2);
+	uint32_t k1 = std::min(k, file1.count());
+	uint32_t k2 = std::min(k, file2.count());
+
+	const RankRecord* top1 = file1.top();
+	double size_in = 0.;
+	for (uint32_t i = 0; i < k1; i++) {
+		uint32_t pos = file2.position(top1[i].node);
+		if (pos != RANK_MISSING && pos < k2) size_in++;
+	}
+
+	return size_in / (k1 + k2 - size_in);
+}
+
+// Function that executes a single query and returns the response line.
+//   TOPK <algo> <k>               -> OK <node>:<score> ...
+//   RANK <algo> <node>            -> OK <rank> <score>
+//   JACCARD <algo1> <algo2> <k>   -> OK <coefficient>
+std::string RankStore::execute(const std::string& query) const {
+	std::istringstream line_stream(query);
+	std::string command, algo;
+	line_stream >> command >> algo;
+
+	std::string out = "OK";
+	try {
+		if (command == "TOPK") {
+			unsigned long k;
+			if (!(line_stream >> k)) return "ERR usage: TOPK <algo> <k>\n";
+
+			const RankFile& file = this->get(algo);
+			k = std::min<unsigned long>(k, file.count());
+			const RankRecord* top = file.top();
+			out.reserve(3 + k * 24);
+			for (unsigned long i = 0; i < k; i++) {
+				out += ' ';
+				append_uint(out, top[i].node);
+				out += ':';
+				append_double(out, top[i].score);
+			}
+		} else if (command == "RANK") {
+			unsigned long node;
+			if (!(line_stream >> node)) return "ERR usage: RANK <algo> <node>\n";
+			if (node > UINT32_MAX) return "ERR node not ranked\n";
+
+			const RankRecord* record = this->get(algo).find(node);
+			if (record == nullptr) return "ERR node not ranked\n";
+			out += ' ';
+			append_uint(out, record->rank);
+			out += ' ';
+			append_double(out, record->score);
+		} else if (command == "JACCARD") {
+			std::string algo2;
+			unsigned long k;
+			if (!(line_stream >> algo2 >> k)) return "ERR usage: JACCARD <algo1> <algo2> <k>\n";
+			if (k == 0 || k > UINT32_MAX) return "ERR k must be between 1 and 4294967295\n";
+
+			out += ' ';
+			append_double(out, this->jaccard(algo, algo2, k));
+		} else {
+			return "ERR unknown command " + command + "\n";
+		}
+	} catch (const std::invalid_argument& e) {
+		return std::string("ERR ") + e.what() + "\n";
+	}
+
+	out += '\n';
+	return out;
+}
+
+#endif
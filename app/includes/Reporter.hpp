@@ -0,0 +1,242 @@
+#ifndef _REPORTER_H
+#define _REPORTER_H
+
+#include "./Utils.hpp"
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// Header of a binary rank file, followed by count RankRecord sorted by rank and by span positions (uint32, indexed by node ID - min_node).
+struct RankFileHeader {
+	char magic[4] = {'P', 'R', 'R', 'K'};
+	uint32_t version = 1;
+
+	// Number of ranked nodes.
+	uint32_t count = 0;
+
+	// Smallest node ID and length of the node ID range covered by the position table.
+	uint32_t min_node = 0;
+	uint32_t span = 0;
+
+	uint32_t reserved = 0;
+};
+
+// Record of a binary rank file: node ID, 1-based rank and score.
+struct RankRecord {
+	uint32_t node;
+	uint32_t rank;
+	double score;
+};
+
+// Position of the nodes that do not appear in a rank file.
+const uint32_t RANK_MISSING = UINT32_MAX;
+
+// Function that formats the top_k nodes of a given algorithm.
+std::string format_topk(const top_k_results& algo_topk, const std::string& algo_str) {
+	std::string out;
+	size_t lines = 0;
+	for (const auto& p : algo_topk) lines += p.second.size() + 1;
+	out.reserve(lines * (algo_str.size() + 40));
+
+	for (const auto& p : algo_topk) {
+		out += "Top ";
+		append_uint(out, p.first);
+		out += '\n';
+		unsigned int i = 1;
+		for (const auto& node : p.second) {
+			append_uint(out, i++);
+			out += ") Node ID: ";
+			append_uint(out, node.first);
+			out += " - ";
+			out += algo_str;
+			out += " value: ";
+			append_double(out, node.second);
+			out += '\n';
+		}
+	}
+	return out;
+}
+
+// Function that writes a string to a stream with a single call.
+inline void write_all(FILE* stream, const std::string& text) {
+	if (std::fwrite(text.data(), 1, text.size(), stream) != text.size())
+		throw std::runtime_error("Write failed\n");
+}
+
+// Function that writes the full ranking of a score vector as a binary file that can be mapped in memory.
+void write_rank_binary(const std::string& path, std::vector<std::pair<unsigned int, double>> scores) {
+
+	// sorting by decreasing score, ties are broken by node ID as in the top-k rankings
+	std::sort(scores.begin(), scores.end(), compareBySecondDecreasing);
+
+	RankFileHeader header;
+	header.count = scores.size();
+	if (!scores.empty()) {
+		auto [min_it, max_it] = std::minmax_element(scores.begin(), scores.end(), [](const std::pair<unsigned int, double>& p1, const std::pair<unsigned int, double>& p2) {
+			return p1.first < p2.first;
+		});
+		header.min_node = min_it->first;
+		header.span = max_it->first - min_it->first + 1;
+	}
+
+	std::vector<RankRecord> records(scores.size());
+	std::vector<uint32_t> positions(header.span, RANK_MISSING);
+	for (uint32_t i = 0; i < scores.size(); i++) {
+		records[i] = RankRecord{scores[i].first, i + 1, scores[i].second};
+		positions[scores[i].first - header.min_node] = i;
+	}
+
+	FILE* file = std::fopen(path.c_str(), "wb");
+	if (file == NULL)
+		throw std::runtime_error("Could not open file");
+
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+			  std::fwrite(records.data(), sizeof(RankRecord), records.size(), file) == records.size() &&
+			  std::fwrite(positions.data(), sizeof(uint32_t), positions.size(), file) == positions.size();
+	if (std::fclose(file) != 0 || !ok)
+		throw std::runtime_error("Write failed\n");
+}
+
+// Class that runs the output jobs (console listings, rank files) in order on a background thread, so that the computation is never blocked on I/O.
+class Reporter {
+	public:
+		// Reporter constructor.
+		Reporter() {
+			this->worker = std::thread(&Reporter::run, this);
+		}
+
+		// Reporter destructor, it waits for all the pending jobs; a failed job can only be reported here.
+		~Reporter() {
+			try {
+				this->stop();
+			} catch (const std::exception& e) {
+				std::cerr << e.what() << std::endl;
+			}
+		}
+
+		// Public functions declaration
+
+		void submit(std::function<void()> job);
+		void print(std::string text);
+		void print_topk(top_k_results algo_topk, std::string algo_str);
+		void save_rank(const std::string& path, std::vector<std::pair<unsigned int, double>> scores);
+		void wait();
+		void stop();
+
+	private:
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::condition_variable idle_cv;
+		std::deque<std::function<void()>> jobs;
+		bool busy = false;
+		bool stopping = false;
+
+		// First exception thrown by a job, thrown again by wait() or stop().
+		std::exception_ptr error;
+
+		// Private functions declaration
+
+		void rethrow();
+		void run();
+};
+
+// Function that enqueues a job, jobs are executed in submission order.
+void Reporter::submit(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->jobs.push_back(std::move(job));
+	}
+	this->cv.notify_one();
+}
+
+// Function that prints a text on the console after all the previously submitted jobs.
+void Reporter::print(std::string text) {
+	this->submit([text = std::move(text)]() {
+		write_all(stdout, text);
+		std::fflush(stdout);
+	});
+}
+
+// Function that prints the top_k nodes of a given algorithm.
+void Reporter::print_topk(top_k_results algo_topk, std::string algo_str) {
+	this->submit([algo_topk = std::move(algo_topk), algo_str = std::move(algo_str)]() {
+		write_all(stdout, format_topk(algo_topk, algo_str));
+		std::fflush(stdout);
+	});
+}
+
+// Function that writes the binary rank file of a score vector.
+void Reporter::save_rank(const std::string& path, std::vector<std::pair<unsigned int, double>> scores) {
+	this->submit([path, scores = std::move(scores)]() mutable {
+		write_rank_binary(path, std::move(scores));
+	});
+}
+
+// Function that throws again the first exception thrown by a job, if any.
+void Reporter::rethrow() {
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::swap(error, this->error);
+	}
+	if (error) std::rethrow_exception(error);
+}
+
+// Function that waits until all the submitted jobs are done, it throws the first exception thrown by a job.
+void Reporter::wait() {
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->idle_cv.wait(lock, [this]() { return this->jobs.empty() && !this->busy; });
+	}
+	this->rethrow();
+}
+
+// Function that waits for the pending jobs and stops the background thread, it throws the first exception thrown by a job.
+void Reporter::stop() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->stopping) return;
+		this->stopping = true;
+	}
+	this->cv.notify_one();
+	this->worker.join();
+	std::fflush(stdout);
+	this->rethrow();
+}
+
+// Function executed by the background thread.
+void Reporter::run() {
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->cv.wait(lock, [this]() { return !this->jobs.empty() || this->stopping; });
+			if (this->jobs.empty()) return;
+			job = std::move(this->jobs.front());
+			this->jobs.pop_front();
+			this->busy = true;
+		}
+
+		// a failed job (e.g. a rank file on a full disk) does not stop the following ones
+		std::exception_ptr job_error;
+		try {
+			job();
+		} catch (...) {
+			job_error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (job_error && !this->error) this->error = job_error;
+			this->busy = false;
+		}
+		this->idle_cv.notify_all();
+	}
+}
+
+#endif
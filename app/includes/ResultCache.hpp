@@ -0,0 +1,224 @@
+#ifndef _RESULT_CACHE_H
+#define _RESULT_CACHE_H
+
+#include "./Utils.hpp"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+// Structure that describes the final result of an algorithm on a dataset, as stored in the result cache.
+struct CachedResult {
+	// Statistics printed by the algorithm (elapsed time, steps, solver details).
+	std::string stats;
+
+	// Number of steps and elapsed time of the computation.
+	unsigned int steps = 0;
+	double elapsed_ms = 0.;
+
+	// (node ID, score) pairs of each score vector of the algorithm (e.g. PageRank Prestige, or authority and hub).
+	std::vector<std::vector<std::pair<unsigned int, double>>> scores;
+};
+
+// Class that stores the results of the algorithms in a directory, one binary file for each result, addressed by a hash of the dataset
+// (its size, modification time and sampled content) and of the algorithm parameters. A result is recomputed only when the dataset or
+// the parameters change; a disabled cache never finds nor stores anything.
+class ResultCache {
+	public:
+		// Default constructor, the cache is disabled.
+		ResultCache() { };
+
+		// ResultCache constructor.
+		ResultCache(std::string dir) {
+			this->dir = dir;
+			std::filesystem::create_directories(dir);
+		}
+
+		// Number of results found and not found.
+		unsigned int hits = 0;
+		unsigned int misses = 0;
+
+		// Public functions declaration
+
+		bool enabled();
+		std::string key(const std::string& ds_path, const std::string& params);
+		bool load(const std::string& key, CachedResult& result);
+		void store(const std::string& key, const CachedResult& result);
+
+	private:
+		std::string dir;
+
+		// Fingerprint of each dataset, computed once per run.
+		std::unordered_map<std::string, uint64_t> fingerprints;
+
+		// Private functions declaration
+
+		std::string path(const std::string& key);
+		void read(const std::string& key, CachedResult& result);
+		void write(const std::string& tmp_path, const std::string& key, const CachedResult& result);
+};
+
+// Magic number and version that identify a result file. The version is also hashed in the keys: it must be increased whenever the
+// file format or the results of an algorithm change, so that the results of the previous code are not loaded.
+const char RESULT_CACHE_MAGIC[4] = {'P', 'R', 'R', 'C'};
+const uint32_t RESULT_CACHE_VERSION = 3;
+
+// Function that returns whether the cache is enabled.
+bool ResultCache::enabled() {
+	return !this->dir.empty();
+}
+
+// Function that returns the key of a result: the name of the dataset, the first word of the parameters (the algorithm) and
+// the hash of the cache version, of the dataset fingerprint and of all the parameters.
+std::string ResultCache::key(const std::string& ds_path, const std::string& params) {
+	auto found = this->fingerprints.find(ds_path);
+	if (found == this->fingerprints.end()) {
+		int64_t mtime = std::filesystem::last_write_time(ds_path).time_since_epoch().count();
+		found = this->fingerprints.emplace(ds_path, fnv1a(&mtime, sizeof(mtime), file_fingerprint(ds_path))).first;
+	}
+
+	std::ostringstream key;
+	key << std::filesystem::path(ds_path).filename().string() << "." << params.substr(0, params.find(' ')) << "."
+		<< std::hex << std::setw(16) << std::setfill('0') << fnv1a(params.data(), params.size(), fnv1a(&RESULT_CACHE_VERSION, sizeof(RESULT_CACHE_VERSION), found->second));
+	return key.str();
+}
+
+// Function that returns the path of the file of a key.
+std::string ResultCache::path(const std::string& key) {
+	return this->dir + "/" + key + ".bin";
+}
+
+// Function that reads the result of a key, it returns false if the cache is disabled or has no such result.
+// A damaged result file (truncated, from another version or of another key) is removed and counted as a miss, so the result is computed again.
+bool ResultCache::load(const std::string& key, CachedResult& result) {
+	if (!this->enabled())
+		return false;
+
+	if (!std::filesystem::exists(this->path(key))) {
+		this->misses++;
+		return false;
+	}
+
+	try {
+		this->read(key, result);
+	} catch (const std::exception& e) {
+		std::cerr << "Discarding result file " << this->path(key) << ": " << e.what() << std::endl;
+		std::error_code ignored;
+		std::filesystem::remove(this->path(key), ignored);
+		result = CachedResult();
+		this->misses++;
+		return false;
+	}
+
+	this->hits++;
+	return true;
+}
+
+// Function that reads the result file of a key, it throws if the file is damaged.
+void ResultCache::read(const std::string& key, CachedResult& result) {
+	std::ifstream file(this->path(key), std::ios::binary);
+	if (!file.is_open())
+		throw std::runtime_error("Could not open result file " + this->path(key));
+
+	auto get = [&](void* data, size_t size) {
+		if (!file.read((char*)data, size))
+			throw std::runtime_error("truncated file");
+	};
+	auto get_string = [&](std::string& text) {
+		uint32_t length;
+		get(&length, sizeof(length));
+		text.resize(length);
+		get(text.data(), length);
+	};
+
+	char magic[4];
+	uint32_t version;
+	get(magic, sizeof(magic));
+	get(&version, sizeof(version));
+	if (std::memcmp(magic, RESULT_CACHE_MAGIC, sizeof(magic)) != 0 || version != RESULT_CACHE_VERSION)
+		throw std::runtime_error("unknown format or version");
+
+	std::string stored_key;
+	get_string(stored_key);
+	if (stored_key != key)
+		throw std::runtime_error("stored for another key");
+
+	get_string(result.stats);
+	get(&result.steps, sizeof(result.steps));
+	get(&result.elapsed_ms, sizeof(result.elapsed_ms));
+
+	uint32_t count;
+	get(&count, sizeof(count));
+	result.scores.resize(count);
+	for (std::vector<std::pair<unsigned int, double>>& scores : result.scores) {
+		uint64_t length;
+		get(&length, sizeof(length));
+
+		// nodes and scores are stored in two arrays, read with a single call each
+		std::vector<uint32_t> nodes(length);
+		std::vector<double> values(length);
+		get(nodes.data(), length * sizeof(uint32_t));
+		get(values.data(), length * sizeof(double));
+
+		scores.resize(length);
+		for (uint64_t i = 0; i < length; i++) scores[i] = std::make_pair(nodes[i], values[i]);
+	}
+}
+
+// Function that writes the result of a key in a temporary file and then renames it, so that a killed run never leaves a truncated result.
+// A result that cannot be written (read-only directory, full disk) is only reported, the run goes on without caching it.
+void ResultCache::store(const std::string& key, const CachedResult& result) {
+	if (!this->enabled())
+		return;
+
+	std::string tmp_path = this->path(key) + ".tmp";
+	try {
+		this->write(tmp_path, key, result);
+		std::filesystem::rename(tmp_path, this->path(key));
+	} catch (const std::exception& e) {
+		std::cerr << "Result " << key << " not cached: " << e.what() << std::endl;
+		std::error_code ignored;
+		std::filesystem::remove(tmp_path, ignored);
+	}
+}
+
+// Function that writes the result of a key in a file, it throws if the file cannot be written.
+void ResultCache::write(const std::string& tmp_path, const std::string& key, const CachedResult& result) {
+	std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw std::runtime_error("Could not open result file " + tmp_path);
+
+	auto put = [&](const void* data, size_t size) { file.write((const char*)data, size); };
+	auto put_string = [&](const std::string& text) {
+		uint32_t length = text.size();
+		put(&length, sizeof(length));
+		put(text.data(), length);
+	};
+
+	put(RESULT_CACHE_MAGIC, sizeof(RESULT_CACHE_MAGIC));
+	put(&RESULT_CACHE_VERSION, sizeof(RESULT_CACHE_VERSION));
+	put_string(key);
+	put_string(result.stats);
+	put(&result.steps, sizeof(result.steps));
+	put(&result.elapsed_ms, sizeof(result.elapsed_ms));
+
+	uint32_t count = result.scores.size();
+	put(&count, sizeof(count));
+	for (const std::vector<std::pair<unsigned int, double>>& scores : result.scores) {
+		uint64_t length = scores.size();
+		std::vector<uint32_t> nodes(length);
+		std::vector<double> values(length);
+		for (uint64_t i = 0; i < length; i++) {
+			nodes[i] = scores[i].first;
+			values[i] = scores[i].second;
+		}
+		put(&length, sizeof(length));
+		put(nodes.data(), length * sizeof(uint32_t));
+		put(values.data(), length * sizeof(double));
+	}
+	file.close();
+
+	if (!file)
+		throw std::runtime_error("Could not write result file " + tmp_path);
+}
+
+#endif
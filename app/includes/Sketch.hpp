@@ -0,0 +1,334 @@
+#ifndef _SKETCH_H
+#define _SKETCH_H
+
+#include <cmath>
+#include <unordered_set>
+#include "./Ingest.hpp"
+#include "./Reporter.hpp"
+
+// Function that mixes a 64 bit value (splitmix64), used to derive the hash seeds of a sketch.
+inline uint64_t splitmix64(uint64_t& state) {
+	uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+// Class that implements a Count-Min sketch: depth rows of width counters, each row with its own hash function.
+// The estimate of a key is never below its true count and, with probability at least 1 - delta, it exceeds it by at most
+// epsilon * N, where N is the total count, epsilon = e / width and delta = e^-depth. Two sketches with the same shape and
+// seed are merged by adding their counters.
+class CountMinSketch {
+	public:
+		// Default constructor.
+		CountMinSketch() { };
+
+		// CountMinSketch constructor.
+		CountMinSketch(unsigned int width, unsigned int depth, uint64_t seed = 42) {
+			this->width = width;
+			this->depth = depth;
+			this->counters.assign((size_t)width * depth, 0);
+
+			for (unsigned int row = 0; row < depth; row++) {
+				this->multipliers.push_back(splitmix64(seed) | 1);
+				this->offsets.push_back(splitmix64(seed));
+			}
+		}
+
+		unsigned int width = 0;
+		unsigned int depth = 0;
+
+		// Public functions declaration
+
+		uint64_t add(unsigned int key, uint64_t count = 1);
+		uint64_t estimate(unsigned int key) const;
+		void merge(const CountMinSketch& other);
+		double epsilon() const;
+		double delta() const;
+		size_t memory_bytes() const;
+
+	private:
+		std::vector<uint64_t> counters;
+		std::vector<uint64_t> multipliers;
+		std::vector<uint64_t> offsets;
+
+		// Private functions declaration
+
+		size_t cell(unsigned int row, unsigned int key) const;
+};
+
+// Function that returns the position of the counter of a key in a row.
+inline size_t CountMinSketch::cell(unsigned int row, unsigned int key) const {
+	return (size_t)row * this->width + ((this->multipliers[row] * key + this->offsets[row]) >> 32) % this->width;
+}
+
+// Function that adds a count to a key and returns its new estimate.
+inline uint64_t CountMinSketch::add(unsigned int key, uint64_t count) {
+	uint64_t estimate = UINT64_MAX;
+	for (unsigned int row = 0; row < this->depth; row++) {
+		uint64_t& counter = this->counters[this->cell(row, key)];
+		counter += count;
+		estimate = std::min(estimate, counter);
+	}
+	return estimate;
+}
+
+// Function that returns the estimate of a key, the minimum of its counters.
+inline uint64_t CountMinSketch::estimate(unsigned int key) const {
+	uint64_t estimate = UINT64_MAX;
+	for (unsigned int row = 0; row < this->depth; row++)
+		estimate = std::min(estimate, this->counters[this->cell(row, key)]);
+	return estimate;
+}
+
+// Function that adds the counters of a sketch with the same shape and seed.
+void CountMinSketch::merge(const CountMinSketch& other) {
+	if (other.width != this->width || other.depth != this->depth || other.multipliers != this->multipliers)
+		throw std::invalid_argument("Only sketches with the same shape and seed can be merged");
+
+	for (size_t i = 0; i < this->counters.size(); i++)
+		this->counters[i] += other.counters[i];
+}
+
+// Function that returns the relative error epsilon = e / width.
+double CountMinSketch::epsilon() const {
+	return std::exp(1.) / this->width;
+}
+
+// Function that returns the failure probability delta = e^-depth.
+double CountMinSketch::delta() const {
+	return std::exp(-(double)this->depth);
+}
+
+// Function that returns the memory used by the counters.
+size_t CountMinSketch::memory_bytes() const {
+	return this->counters.size() * sizeof(uint64_t);
+}
+
+// Class that keeps the keys with the largest estimates seen so far, at most capacity of them, in a min-heap indexed by key.
+class HeavyHitters {
+	public:
+		// HeavyHitters constructor.
+		HeavyHitters(unsigned int capacity) {
+			this->capacity = capacity;
+		}
+
+		// (estimate, key) pairs, the smallest estimate at the root.
+		std::vector<std::pair<uint64_t, unsigned int>> heap;
+
+		// Public functions declaration
+
+		void offer(unsigned int key, uint64_t estimate);
+
+	private:
+		unsigned int capacity;
+
+		// Position of each key in the heap.
+		std::unordered_map<unsigned int, size_t> position;
+
+		// Private functions declaration
+
+		void sift_down(size_t i);
+		void place(size_t i, std::pair<uint64_t, unsigned int> item);
+};
+
+// Function that stores an item at a position of the heap and updates the index.
+inline void HeavyHitters::place(size_t i, std::pair<uint64_t, unsigned int> item) {
+	this->heap[i] = item;
+	this->position[item.second] = i;
+}
+
+// Function that moves down an item whose estimate has grown.
+void HeavyHitters::sift_down(size_t i) {
+	std::pair<uint64_t, unsigned int> item = this->heap[i];
+	while (true) {
+		size_t child = 2 * i + 1;
+		if (child >= this->heap.size()) break;
+		if (child + 1 < this->heap.size() && this->heap[child + 1] < this->heap[child]) child++;
+		if (!(this->heap[child] < item)) break;
+		this->place(i, this->heap[child]);
+		i = child;
+	}
+	this->place(i, item);
+}
+
+// Function that updates the estimate of a key, inserting it if there is room or if it beats the smallest one.
+void HeavyHitters::offer(unsigned int key, uint64_t estimate) {
+	auto found = this->position.find(key);
+	if (found != this->position.end()) {
+		// the estimates of a Count-Min sketch only grow, so the key can only move down
+		this->heap[found->second].first = estimate;
+		this->sift_down(found->second);
+		return;
+	}
+
+	if (this->heap.size() < this->capacity) {
+		// moving up the new key
+		this->heap.push_back(std::make_pair(estimate, key));
+		size_t i = this->heap.size() - 1;
+		std::pair<uint64_t, unsigned int> item = this->heap[i];
+		while (i > 0 && item < this->heap[(i - 1) / 2]) {
+			this->place(i, this->heap[(i - 1) / 2]);
+			i = (i - 1) / 2;
+		}
+		this->place(i, item);
+		return;
+	}
+
+	if (this->capacity == 0 || estimate <= this->heap[0].first) return;
+
+	// replacing the smallest key
+	this->position.erase(this->heap[0].second);
+	this->heap[0] = std::make_pair(estimate, key);
+	this->sift_down(0);
+}
+
+// This class estimates the InDegree top-k of an edge stream in fixed memory: each parser thread counts the destinations in its own
+// Count-Min sketch and keeps its heavy hitters; at the end the sketches are merged and the candidates of all the threads are
+// ranked by their merged estimate. The memory does not depend on the number of nodes or edges.
+class InDegreeSketch {
+	public:
+		// InDegreeSketch constructor.
+		InDegreeSketch(std::vector<unsigned int> top_k, unsigned int width, unsigned int depth, unsigned int candidates) {
+			this->top_k = top_k;
+			this->width = width;
+			this->depth = depth;
+			this->candidates = std::max(candidates, *std::max_element(top_k.begin(), top_k.end()));
+		}
+
+		// Vector that indicates the k value for which the top-k ranking is computed.
+		std::vector<unsigned int> top_k;
+
+		// Vector that stores the estimated top-k results, for each value of k.
+		top_k_results IN_topk;
+
+		std::string algo_str = "In Degree (sketch)";
+
+		// Number of edges of the stream, and number of nodes read from the header (0 if the stream has no header).
+		unsigned long edges = 0;
+		int nodes = 0;
+
+		// Elapsed time, the parsing of the stream included.
+		Duration elapsed;
+
+		// Public functions declaration
+
+		void compute(const std::string& path, unsigned int workers = default_workers());
+		void get_topk_results();
+		void print_topk_results();
+		std::string get_stats();
+		std::string compare(top_k_results& exact);
+		size_t memory_bytes();
+
+	private:
+		unsigned int width;
+		unsigned int depth;
+		unsigned int candidates;
+		unsigned int workers = 1;
+
+		// Merged sketch of all the threads.
+		CountMinSketch sketch;
+
+		// (node ID, estimated in-links) pairs of the candidates, sorted by decreasing estimate.
+		std::vector<std::pair<unsigned int, double>> ranking;
+
+		// Private functions declaration
+
+		double norm();
+};
+
+// Function that counts the destinations of the stream (a SNAP file, plain or compressed, or "-" for the standard input).
+void InDegreeSketch::compute(const std::string& path, unsigned int workers) {
+	auto start = now();
+	this->workers = workers;
+
+	std::vector<CountMinSketch> sketches(workers, CountMinSketch(this->width, this->depth));
+	std::vector<HeavyHitters> hitters(workers, HeavyHitters(this->candidates));
+	std::vector<unsigned long> edge_counts(workers, 0);
+
+	auto on_edge = [&](unsigned int w, unsigned int from, unsigned int to) {
+		(void)from;
+		hitters[w].offer(to, sketches[w].add(to));
+		edge_counts[w]++;
+	};
+
+	std::string head;
+	if (path == "-")
+		for_each_edge_stream(stdin, workers, on_edge, head);
+	else {
+		head = read_file_head(path);
+		for_each_edge(path, workers, on_edge);
+	}
+	int header_edges = 0;
+	read_snap_header(head, this->nodes, header_edges);
+	this->edges = std::accumulate(edge_counts.begin(), edge_counts.end(), 0ul);
+
+	// merging the sketches, and ranking the candidates of every thread with the merged counts
+	this->sketch = sketches[0];
+	for (unsigned int w = 1; w < workers; w++) this->sketch.merge(sketches[w]);
+
+	std::unordered_set<unsigned int> keys;
+	for (const HeavyHitters& h : hitters)
+		for (const std::pair<uint64_t, unsigned int>& item : h.heap) keys.insert(item.second);
+
+	this->ranking.clear();
+	for (unsigned int key : keys) this->ranking.push_back(std::make_pair(key, (double)this->sketch.estimate(key)));
+
+	this->elapsed = now() - start;
+}
+
+// Function that returns the factor that normalizes the in-links like InDegree, 1 / (n - 1), or 1 if the number of nodes is unknown.
+double InDegreeSketch::norm() {
+	return this->nodes > 1 ? 1. / (this->nodes - 1) : 1.;
+}
+
+// Function that retrieves the estimated top-k nodes, normalized like the exact InDegree.
+void InDegreeSketch::get_topk_results() {
+	std::vector<std::pair<unsigned int, double>> pairs = this->ranking;
+	for (std::pair<unsigned int, double>& pair : pairs) pair.second *= this->norm();
+	select_topk(pairs, this->top_k, this->IN_topk);
+}
+
+// Function that prints the results.
+void InDegreeSketch::print_topk_results() {
+	write_all(stdout, format_topk(this->IN_topk, this->algo_str));
+	std::fflush(stdout);
+}
+
+// Function that returns the memory used by the sketches and the heavy hitters of all the threads.
+size_t InDegreeSketch::memory_bytes() {
+	size_t heap_entry = sizeof(std::pair<uint64_t, unsigned int>) + sizeof(std::pair<unsigned int, size_t>) + 2 * sizeof(void*);
+	return this->workers * (this->sketch.memory_bytes() + (size_t)this->candidates * heap_entry);
+}
+
+// Function that returns the elapsed time, the memory and the error bounds of the estimates.
+std::string InDegreeSketch::get_stats() {
+	std::ostringstream stats;
+	stats << "Elapsed: " << this->elapsed.count() << " ms \t Edges: " << this->edges << " \t Memory: " << (double)this->memory_bytes() / (1 << 20) << " MB" << std::endl;
+	stats << "Width: " << this->width << " \t Depth: " << this->depth << " \t Candidates: " << this->candidates
+		  << " \t epsilon: " << this->sketch.epsilon() << " \t delta: " << this->sketch.delta() << std::endl;
+	stats << "With probability " << 1 - this->sketch.delta() << " each estimate exceeds the true value by at most "
+		  << this->sketch.epsilon() * this->edges << " in-links (" << this->sketch.epsilon() * this->edges * this->norm() << ")" << std::endl;
+	return stats.str();
+}
+
+// Function that returns the Jaccard coefficient between the estimated and the exact top-k nodes, for each value of k.
+std::string InDegreeSketch::compare(top_k_results& exact) {
+	std::string out;
+	for (unsigned int k : this->top_k) {
+		std::unordered_set<unsigned int> estimated;
+		for (const std::pair<unsigned int, double>& pair : this->IN_topk[k]) estimated.insert(pair.first);
+
+		double common = 0.;
+		for (const std::pair<unsigned int, double>& pair : exact[k]) common += estimated.count(pair.first);
+
+		out += "TOP ";
+		append_uint(out, k);
+		out += "\tSketch VS InDegree: ";
+		append_double(out, common / (estimated.size() + exact[k].size() - common));
+		out += "\n";
+	}
+	return out;
+}
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef _TASK_GRAPH_H
+#define _TASK_GRAPH_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Class that runs jobs on a fixed set of threads with work stealing: each thread has its own deque, it takes the most recent
+// job of its deque and, when the deque is empty, the oldest job of the others. A thread that waits for a parallel loop runs the
+// iterations of that loop in the meantime, and only those, so nested parallel loops share the same threads instead of starting new ones.
+class WorkPool {
+	public:
+		// WorkPool constructor, it starts the threads.
+		WorkPool(unsigned int threads);
+
+		// WorkPool destructor, it waits for the pending jobs and stops the threads.
+		~WorkPool();
+
+		WorkPool(const WorkPool&) = delete;
+		WorkPool& operator=(const WorkPool&) = delete;
+
+		// Public functions declaration
+
+		unsigned int size();
+		void submit(std::function<void()> job);
+		void run_all(unsigned int jobs, const std::function<void(unsigned int)>& fn);
+
+	private:
+		// Deque of the jobs submitted by a thread.
+		struct Queue {
+			std::mutex lock;
+			std::deque<std::function<void()>> jobs;
+		};
+
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> threads;
+
+		// Number of queued jobs, and the condition on which the idle threads sleep.
+		std::atomic<size_t> pending{0};
+		std::mutex idle_lock;
+		std::condition_variable idle;
+		bool stopping = false;
+
+		// Index of the deque of the calling thread, -1 for the threads outside the pool.
+		static inline thread_local int current = -1;
+
+		// Private functions declaration
+
+		bool run_one();
+		void work(unsigned int index);
+};
+
+// Function that starts the threads, with one more deque for the jobs submitted from outside the pool.
+WorkPool::WorkPool(unsigned int threads) {
+	for (unsigned int i = 0; i <= threads; i++) this->queues.push_back(std::make_unique<Queue>());
+	for (unsigned int i = 0; i < threads; i++) this->threads.emplace_back(&WorkPool::work, this, i);
+}
+
+// Function that waits for the pending jobs and stops the threads.
+WorkPool::~WorkPool() {
+	{
+		std::lock_guard<std::mutex> guard(this->idle_lock);
+		this->stopping = true;
+	}
+	this->idle.notify_all();
+	for (std::thread& t : this->threads) t.join();
+}
+
+// Function that returns the number of threads of the pool.
+unsigned int WorkPool::size() {
+	return this->threads.size();
+}
+
+// Function that queues a job on the deque of the calling thread, or on the shared one from outside the pool.
+void WorkPool::submit(std::function<void()> job) {
+	Queue& queue = *this->queues[current >= 0 ? current : this->threads.size()];
+	{
+		std::lock_guard<std::mutex> guard(queue.lock);
+		queue.jobs.push_back(std::move(job));
+	}
+	{
+		std::lock_guard<std::mutex> guard(this->idle_lock);
+		this->pending++;
+	}
+	this->idle.notify_one();
+}
+
+// Function that runs one queued job, the most recent of the own deque or the oldest of another one; it returns false if there is none.
+bool WorkPool::run_one() {
+	std::function<void()> job;
+	unsigned int own = current >= 0 ? current : this->threads.size();
+
+	for (unsigned int i = 0; i < this->queues.size() && !job; i++) {
+		Queue& queue = *this->queues[(own + i) % this->queues.size()];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.jobs.empty()) continue;
+		if (i == 0) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		} else {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+	}
+
+	if (!job) return false;
+	this->pending--;
+	job();
+	return true;
+}
+
+// Function that runs the jobs of a pool thread, sleeping while there are none.
+void WorkPool::work(unsigned int index) {
+	current = index;
+	while (true) {
+		if (this->run_one()) continue;
+
+		std::unique_lock<std::mutex> guard(this->idle_lock);
+		this->idle.wait(guard, [&]() { return this->pending > 0 || this->stopping; });
+		if (this->stopping && this->pending == 0) return;
+	}
+}
+
+// Function that runs fn(job) for each job in [0, jobs) and waits for all of them. The calling thread and the pool threads take the jobs
+// from the same counter, so while waiting the calling thread runs only the jobs of this loop: it sleeps once all of them are taken, until the
+// ones running on other threads end. The first exception thrown by a job is thrown again.
+void WorkPool::run_all(unsigned int jobs, const std::function<void(unsigned int)>& fn) {
+
+	// the state is shared with the queued jobs, which may start after the loop ended and then find nothing to do
+	struct Batch {
+		std::atomic<unsigned int> next{0};
+		std::mutex lock;
+		std::condition_variable done;
+		unsigned int remaining;
+		std::exception_ptr error;
+	};
+	auto batch = std::make_shared<Batch>();
+	batch->remaining = jobs;
+
+	auto take = [batch, jobs, &fn]() {
+		unsigned int job;
+		while ((job = batch->next.fetch_add(1)) < jobs) {
+			std::exception_ptr job_error;
+			try {
+				fn(job);
+			} catch (...) {
+				job_error = std::current_exception();
+			}
+			std::lock_guard<std::mutex> guard(batch->lock);
+			if (job_error && !batch->error) batch->error = job_error;
+			if (--batch->remaining == 0) batch->done.notify_all();
+		}
+	};
+
+	for (unsigned int job = 1; job < jobs; job++)
+		this->submit(take);
+	take();
+
+	std::unique_lock<std::mutex> guard(batch->lock);
+	batch->done.wait(guard, [&]() { return batch->remaining == 0; });
+	if (batch->error) std::rethrow_exception(batch->error);
+}
+
+// Function that returns the pool shared by the whole application, one thread for each core besides the calling one.
+WorkPool& shared_pool() {
+	static WorkPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+	return pool;
+}
+
+// Class that runs a set of tasks on a pool, each one as soon as the tasks it depends on are completed. The thread that runs the graph
+// takes the ready tasks too, but never other jobs of the pool.
+class TaskGraph {
+	public:
+		// TaskGraph constructor.
+		TaskGraph(WorkPool& pool = shared_pool()) : pool(pool) { };
+
+		// Public functions declaration
+
+		unsigned int add(std::string name, std::function<void()> fn, std::vector<unsigned int> dependencies = {});
+		void run();
+		std::string timeline();
+
+	private:
+		// Task of the graph, with the tasks that wait for it and the number of its dependencies not completed yet.
+		struct Task {
+			std::string name;
+			std::function<void()> fn;
+			std::vector<unsigned int> dependents;
+			unsigned int remaining = 0;
+			std::chrono::duration<double, std::milli> start, end;
+		};
+
+		// State of a run, shared with the jobs queued on the pool: the ready tasks not taken yet, the number of tasks not completed
+		// and the first exception thrown by a task. A job that finds no ready task, since a waiting thread took it, does nothing.
+		struct State {
+			std::mutex lock;
+			std::condition_variable changed;
+			std::deque<unsigned int> ready;
+			unsigned int running = 0;
+			std::exception_ptr error;
+		};
+
+		WorkPool& pool;
+		std::vector<Task> tasks;
+		std::shared_ptr<State> state;
+		std::chrono::high_resolution_clock::time_point started;
+
+		// Private functions declaration
+
+		void launch(unsigned int task);
+		void execute(unsigned int task);
+};
+
+// Function that adds a task that runs after its dependencies and returns its index.
+unsigned int TaskGraph::add(std::string name, std::function<void()> fn, std::vector<unsigned int> dependencies) {
+	unsigned int index = this->tasks.size();
+	Task task;
+	task.name = name;
+	task.fn = fn;
+	task.remaining = dependencies.size();
+	this->tasks.push_back(task);
+
+	for (unsigned int dependency : dependencies) {
+		if (dependency >= index)
+			throw std::invalid_argument("A task can depend only on the tasks added before it");
+		this->tasks[dependency].dependents.push_back(index);
+	}
+	return index;
+}
+
+// Function that marks a task whose dependencies are completed as ready and queues a job on the pool that takes a ready task.
+void TaskGraph::launch(unsigned int index) {
+	{
+		std::lock_guard<std::mutex> guard(this->state->lock);
+		this->state->ready.push_back(index);
+	}
+	this->state->changed.notify_all();
+
+	this->pool.submit([this, state = this->state]() {
+		unsigned int index;
+		{
+			std::lock_guard<std::mutex> guard(state->lock);
+			if (state->ready.empty()) return;
+			index = state->ready.front();
+			state->ready.pop_front();
+		}
+		this->execute(index);
+	});
+}
+
+// Function that runs a task and launches the dependents that become ready. After an exception the tasks that are still waiting are skipped.
+void TaskGraph::execute(unsigned int index) {
+	Task& task = this->tasks[index];
+	bool skip;
+	{
+		std::lock_guard<std::mutex> guard(this->state->lock);
+		skip = (bool)this->state->error;
+	}
+
+	std::exception_ptr task_error;
+	task.start = std::chrono::high_resolution_clock::now() - this->started;
+	if (!skip) {
+		try {
+			task.fn();
+		} catch (...) {
+			task_error = std::current_exception();
+		}
+	}
+	task.end = std::chrono::high_resolution_clock::now() - this->started;
+
+	std::vector<unsigned int> ready;
+	{
+		std::lock_guard<std::mutex> guard(this->state->lock);
+		if (task_error && !this->state->error) this->state->error = task_error;
+		for (unsigned int dependent : task.dependents)
+			if (--this->tasks[dependent].remaining == 0) ready.push_back(dependent);
+		// the dependents that became ready replace this task among the running ones
+		this->state->running += ready.size();
+		this->state->running--;
+		if (this->state->running == 0) this->state->changed.notify_all();
+	}
+	for (unsigned int dependent : ready) this->launch(dependent);
+}
+
+// Function that runs all the tasks and waits for them, running the ready ones in the meantime. The first exception thrown by a task is thrown again.
+void TaskGraph::run() {
+	this->started = std::chrono::high_resolution_clock::now();
+	this->state = std::make_shared<State>();
+
+	std::vector<unsigned int> roots;
+	for (unsigned int i = 0; i < this->tasks.size(); i++)
+		if (this->tasks[i].remaining == 0) roots.push_back(i);
+
+	this->state->running = roots.size();
+	for (unsigned int root : roots) this->launch(root);
+
+	while (true) {
+		unsigned int index;
+		{
+			std::unique_lock<std::mutex> guard(this->state->lock);
+			this->state->changed.wait(guard, [&]() { return this->state->running == 0 || !this->state->ready.empty(); });
+			if (this->state->running == 0) break;
+			index = this->state->ready.front();
+			this->state->ready.pop_front();
+		}
+		this->execute(index);
+	}
+
+	if (this->state->error) std::rethrow_exception(this->state->error);
+}
+
+// Function that returns the start and the end of each task, relative to the start of the run, and the wall time against the sum of the tasks.
+std::string TaskGraph::timeline() {
+	std::string out;
+	double wall = 0., total = 0.;
+	for (const Task& task : this->tasks) {
+		out += task.name + ": " + std::to_string(task.start.count()) + " - " + std::to_string(task.end.count()) + " ms\n";
+		wall = std::max(wall, task.end.count());
+		total += (task.end - task.start).count();
+	}
+	return out + "Wall: " + std::to_string(wall) + " ms \t Sum of the tasks: " + std::to_string(total) + " ms\n";
+}
+
+#endif
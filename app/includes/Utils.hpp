@@ -10,6 +10,12 @@
 #include <algorithm>
 #include <numeric>
 #include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <charconv>
+#include <thread>
+#include <functional>
+#include "./TaskGraph.hpp"
 
 // Typedef for node pair: (from_node_id, to_node_id).
 using nodes_pair = std::pair<unsigned int, unsigned int>;
@@ -37,9 +43,48 @@ bool compareBySecondIncreasing(const nodes_pair& pair1, const nodes_pair& pair2)
     return pair1.second < pair2.second;
 }
 
-// Function that compares the second element of a node pair in decreasing order.
+// Function that compares the second element of a node pair in decreasing order, ties are broken by increasing node ID so that
+// the top-k rankings and the rank files agree on the same order.
 bool compareBySecondDecreasing(const std::pair<unsigned int, double>& pair1, const std::pair<unsigned int, double>& pair2) {
-    return pair1.second > pair2.second;
+    return pair1.second > pair2.second || (pair1.second == pair2.second && pair1.first < pair2.first);
+}
+
+// Function that appends an unsigned integer to a string.
+inline void append_uint(std::string& out, unsigned long value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Function that appends a double to a string, with the same format used by std::cout (6 significant digits).
+inline void append_double(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    out.append(buffer, result.ptr);
+}
+
+// Function that returns the number of worker threads used by the parallel parts of the algorithms.
+unsigned int default_workers() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Function that runs fn(worker) for each worker and waits for all of them. The workers run on the shared pool, so the parallel loops of
+// algorithms running at the same time share its threads instead of starting one thread per core each.
+void parallel_run(unsigned int workers, const std::function<void(unsigned int)>& fn) {
+    if (workers <= 1) {
+        fn(0);
+        return;
+    }
+
+    shared_pool().run_all(workers, fn);
+}
+
+// Function that obtains the top_k nodes from a vector of (node ID, score) pairs.
+void select_topk(std::vector<std::pair<unsigned int, double>> pairs, std::vector<unsigned int>& topk, top_k_results& algo_topk) {
+    std::sort(pairs.begin(), pairs.end(), compareBySecondDecreasing);
+
+    for (unsigned int k : topk)
+        algo_topk[k] = std::vector<std::pair<unsigned int, double>>(pairs.begin(), pairs.begin() + std::min<size_t>(k, pairs.size()));
 }
 
 // Function that returns the stream istance of a given dataset path.
@@ -52,4 +97,35 @@ std::ifstream readDataset(const std::string& filepath) {
     return file;
 }
 
-#endif
\ No newline at end of file
+// Function that computes the 64 bit FNV-1a hash of a buffer, starting from a given hash value.
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function that computes a fast fingerprint of a file: its size and a hash of 64 KB samples taken at the beginning, in the middle and at the end.
+uint64_t file_fingerprint(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file");
+
+    uint64_t size = std::filesystem::file_size(filepath);
+    uint64_t hash = fnv1a(&size, sizeof(size));
+
+    const uint64_t sample = 1 << 16;
+    std::vector<char> buffer(sample);
+    for (uint64_t offset : {(uint64_t)0, size / 2, size > sample ? size - sample : 0}) {
+        file.seekg(offset);
+        file.read(buffer.data(), sample);
+        hash = fnv1a(buffer.data(), file.gcount(), hash);
+        file.clear();
+    }
+
+    return hash;
+}
+
+#endif
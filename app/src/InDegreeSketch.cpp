@@ -0,0 +1,76 @@
+#include "../includes/Sketch.hpp"
+#include "../includes/RankStore.hpp"
+
+// Function that returns the top-k results stored in an InDegree rank file, for each value of k.
+top_k_results read_exact_topk(const std::string& path, const std::vector<unsigned int>& top_k) {
+	RankFile exact(path);
+	top_k_results results;
+	for (unsigned int k : top_k) {
+		uint32_t count = std::min<uint32_t>(k, exact.count());
+		for (uint32_t i = 0; i < count; i++) results[k].push_back(std::make_pair(exact.top()[i].node, exact.top()[i].score));
+	}
+	return results;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: ./indegree_sketch <dataset | -> [options]\n"
+				  << "  --top <k>            largest k of the ranking (at most 2^29), the rankings for the powers of 2 up to k are computed (default 1024)\n"
+				  << "  --width <w>          counters in each row of the Count-Min sketch (default 262144)\n"
+				  << "  --depth <d>          rows of the Count-Min sketch (default 4)\n"
+				  << "  --candidates <c>     heavy hitters kept by each thread (default 4 * k)\n"
+				  << "  --workers <n>        parser threads, each one with its own sketch (default one for each core)\n"
+				  << "  --exact <file>       InDegree .rank file of the same dataset, to compare the rankings\n"
+				  << "  --verbose            print the estimated rankings\n"
+				  << "The dataset is a SNAP file, plain or compressed; - reads the edges from the standard input.\n";
+		return 1;
+	}
+
+	std::string path = argv[1];
+	unsigned int top = 1024, width = 1 << 18, depth = 4, candidates = 0, workers = default_workers();
+	std::string exact_path;
+	bool verbose = false;
+
+	for (int i = 2; i < argc; i++) {
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+			return argv[++i];
+		};
+		auto number = [&]() -> unsigned int {
+			unsigned long n = std::stoul(value());
+			if (n > UINT32_MAX) throw std::invalid_argument("Value out of range for " + arg);
+			return n;
+		};
+
+		if (arg == "--top") top = number();
+		else if (arg == "--width") width = number();
+		else if (arg == "--depth") depth = number();
+		else if (arg == "--candidates") candidates = number();
+		else if (arg == "--workers") workers = number();
+		else if (arg == "--exact") exact_path = value();
+		else if (arg == "--verbose") verbose = true;
+		else throw std::invalid_argument("Unknown option " + arg);
+	}
+	if (top == 0 || width == 0 || depth == 0 || workers == 0) throw std::invalid_argument("--top, --width, --depth and --workers must be at least 1");
+
+	// the powers of 2 up to top and the default 4 * top candidates fit in 32 bits
+	if (top > (1u << 29)) throw std::invalid_argument("--top must be at most 536870912");
+
+	std::vector<unsigned int> top_k;
+	for (unsigned int k = 1; k <= top; k *= 2) top_k.push_back(k);
+
+	InDegreeSketch sketch(top_k, width, depth, candidates > 0 ? candidates : 4 * top);
+	sketch.compute(path, workers);
+	sketch.get_topk_results();
+
+	std::cout << sketch.get_stats();
+	if (verbose) sketch.print_topk_results();
+
+	if (!exact_path.empty()) {
+		top_k_results exact = read_exact_topk(exact_path, top_k);
+		std::cout << sketch.compare(exact);
+	}
+
+	return 0;
+}
@@ -1,14 +1,20 @@
 #include "../includes/InDegree.hpp"
 #include "../includes/PageRank.hpp"
 #include "../includes/HITS.hpp"
+#include "../includes/Fused.hpp"
 #include "../includes/Jaccard.hpp"
+#include "../includes/Options.hpp"
+#include "../includes/Reporter.hpp"
+#include "../includes/ResultCache.hpp"
+#include "../includes/TaskGraph.hpp"
 #include <filesystem>
 #include <ctime>
 #include <fstream>
 
 
-int main(){
+int main(int argc, char* argv[]){
 	bool verbose;
+	AppOptions options = parse_options(argc, argv);
 
 	std::cout << "------------------------------------- PageRank - HITS - InDegree Comparison ------------------------------------- \n\n";
 	std::cout << "Do you want to activate VERBOSE mode to see the top-k nodes for each k and algorithms? (0/1) ";
@@ -23,10 +29,14 @@ int main(){
 
 	// Fstream .csv file creation
 
-	const auto p1 = std::chrono::system_clock::now();
-	std::time_t today_time = std::chrono::system_clock::to_time_t(p1);
-    std::string result_path = std::ctime(&today_time);
-	std::filesystem::create_directory("../results/" + result_path);
+	std::string result_path = options.results_dir;
+	if (result_path.empty()) {
+		const auto p1 = std::chrono::system_clock::now();
+		std::time_t today_time = std::chrono::system_clock::to_time_t(p1);
+		result_path = "../results/" + std::string(std::ctime(&today_time));
+		result_path.pop_back();  // std::ctime ends with a newline
+	}
+	std::filesystem::create_directories(result_path);
 
 	std::string csv_jaccard = "jaccard_results.csv";
 	std::string csv_elapsed = "elapsed_results.csv";
@@ -36,17 +46,36 @@ int main(){
 	std::fstream stream_elapsed;
 	std::fstream stream_steps;
 
-    stream_jaccard.open("../results/" + result_path + "/" + csv_jaccard, std::ios::out | std::ios::app);
+    stream_jaccard.open(result_path + "/" + csv_jaccard, std::ios::out | std::ios::trunc);
     stream_jaccard << "dataset,top_k,ID_A,ID_H,ID_PR,PR_A,PR_H,A_H\n";
 
-    stream_elapsed.open("../results/" + result_path + "/" + csv_elapsed, std::ios::out | std::ios::app);
+    stream_elapsed.open(result_path + "/" + csv_elapsed, std::ios::out | std::ios::trunc);
     stream_elapsed << "dataset,PR,HITS,ID\n";
 
-    stream_steps.open("../results/" + result_path + "/" + csv_steps, std::ios::out | std::ios::app);
+    stream_steps.open(result_path + "/" + csv_steps, std::ios::out | std::ios::trunc);
     stream_steps << "dataset,PR,HITS\n";
 
+	if (options.checkpoint_every > 0) std::filesystem::create_directories(options.checkpoint_dir);
+
 	std::cout << std::endl;
 
+	// console listings and rank files are written by a background thread, in order
+	Reporter reporter;
+	std::string result_dir = result_path + "/";
+
+	// final results of the previous runs, addressed by the dataset and by the parameters
+	ResultCache cache = options.cache ? ResultCache(options.cache_dir) : ResultCache();
+
+	const double t_prob = 0.85;
+	std::ostringstream pr_params, hits_params;
+	pr_params << "pagerank solver=" << options.pagerank_solver << " damping=" << t_prob;
+	if (options.pagerank_solver == "push") pr_params << " tolerance=" << options.push_tolerance;
+	if (options.blockrank) pr_params << " blockrank=" << options.blockrank_size;
+	if (!options.blockrank_hosts.empty()) pr_params << " hosts=" << file_fingerprint(options.blockrank_hosts);
+	if (options.blockrank_compare) pr_params << " compare";
+	hits_params << "hits solver=" << options.hits_solver;
+	if (options.hits_solver == "lanczos") hits_params << " rank=" << options.hits_rank << " subspace=" << options.hits_subspace;
+
 	for (std::string ds : datasets) {
 
 		// Fill the vector of top_k value  
@@ -55,58 +84,178 @@ int main(){
 
 		if (ds == "web-BerkStan.txt" || ds == "web-Google.txt") top_k.push_back(std::pow(2,19));
 
-		std::cout << "-------------------" << ds << "---------------------" << std::endl;
-		
-		// InDegree
-		std::cout << "IN_DEGREE" << std::endl;
-		InDegree in_degree = InDegree(top_k,"../dataset/" + ds);
-		in_degree.compute();
-		in_degree.print_stats();
-		in_degree.get_topk_results();
-		if(verbose) in_degree.print_topk_results();
-		std::cout << std::endl;
-
-		// PageRank
-		std::cout << "PAGE_RANK" << std::endl;
-		PageRank page_rank = PageRank(top_k,"../dataset/" + ds, 0.85);
-		page_rank.compute();
-		page_rank.print_stats();
-		page_rank.get_topk_results();
-		if(verbose) page_rank.print_topk_results();
-		page_rank.free_T_matrix_memory();
-		std::cout << std::endl;
-
-		// HITS
-		std::cout << "HITS" << std::endl;
-		HITS hits = HITS(top_k,"../dataset/" + ds);
-		hits.compute();
-		hits.print_stats();
-		hits.get_topk_hub();
-		hits.get_topk_authority();
+		reporter.print("-------------------" + ds + "---------------------\n");
+
+		// the dataset can also be a .gz (or .zst) archive, decompressed while it is parsed
+		std::string ds_path = resolve_dataset("../dataset/" + ds);
+
+		// results of this dataset, loaded from the cache or computed below
+		std::string in_key = cache.enabled() ? cache.key(ds_path, "indegree") : "";
+		std::string pr_key = cache.enabled() ? cache.key(ds_path, pr_params.str()) : "";
+		std::string hits_key = cache.enabled() ? cache.key(ds_path, hits_params.str()) : "";
+		CachedResult in_result, pr_result, hits_result;
+		Duration in_load, pr_load, hits_load;
+		auto load = [&](const std::string& key, CachedResult& result, Duration& elapsed) {
+			auto start = now();
+			bool loaded = cache.load(key, result);
+			elapsed = now() - start;
+			return loaded;
+		};
+		auto loaded_note = [](Duration elapsed) { return "Loaded from the cache in " + std::to_string(elapsed.count()) + " ms\n"; };
+		bool in_loaded = load(in_key, in_result, in_load);
+		bool pr_loaded = load(pr_key, pr_result, pr_load);
+		bool hits_loaded = load(hits_key, hits_result, hits_load);
+
+		// the stages of this dataset run as tasks on the shared pool, each one after the stages it needs; without --concurrent the
+		// algorithms are chained, so that one graph at a time is in memory
+		TaskGraph tasks;
+		std::string pr_notes, hits_notes, fused_stats;
+		top_k_results IN_topk, PR_topk, authority_topk, hub_topk;
+		std::unique_ptr<JaccardCoefficient> jaccard;
+
+		// InDegree, PageRank and HITS sharing the scans of the in-links, their results are the ones of the power iterations
+		bool fused_run = options.fused && !(in_loaded && pr_loaded && hits_loaded);
+		unsigned int in_task, pr_task, hits_task;
+		if (fused_run) {
+			in_task = pr_task = hits_task = tasks.add("fused", [&]() {
+				FusedScan fused = FusedScan(top_k, ds_path, t_prob);
+				fused.compute();
+				fused_stats = fused.get_stats();
+
+				auto stats = [](Duration elapsed, unsigned int steps) {
+					return "Elapsed: " + std::to_string(elapsed.count()) + " ms \t Steps: " + std::to_string(steps) + "\n";
+				};
+				in_result = CachedResult{"Elapsed: " + std::to_string(fused.IN_elapsed.count()) + " ms\n", 0, fused.IN_elapsed.count(), {fused.get_in_degree_scores()}};
+				pr_result = CachedResult{stats(fused.PR_elapsed, fused.PR_steps), fused.PR_steps, fused.PR_elapsed.count(), {fused.get_pagerank_scores()}};
+				hits_result = CachedResult{stats(fused.HITS_elapsed, fused.HITS_steps), fused.HITS_steps, fused.HITS_elapsed.count(), {fused.get_authority_scores(), fused.get_hub_scores()}};
+				fused.free_matrix_memory();
+
+				cache.store(in_key, in_result);
+				cache.store(pr_key, pr_result);
+				cache.store(hits_key, hits_result);
+			});
+			in_loaded = pr_loaded = hits_loaded = false;
+		} else {
+			// InDegree
+			in_task = tasks.add("indegree", [&]() {
+				if (in_loaded) return;
+				InDegree in_degree = InDegree(top_k,ds_path);
+				in_degree.compute();
+				in_result = CachedResult{in_degree.get_stats(), 0, in_degree.elapsed.count(), {in_degree.get_scores()}};
+				cache.store(in_key, in_result);
+			});
+
+			// PageRank
+			pr_task = tasks.add("pagerank", [&]() {
+				if (pr_loaded) return;
+				PageRank page_rank = PageRank(top_k,ds_path, t_prob, options.pagerank_solver == "push");
+				std::string pr_checkpoint = options.checkpoint_dir + "/" + ds + ".pagerank.ckpt";
+				if (options.resume && page_rank.resume(pr_checkpoint)) pr_notes += "Resumed at step " + std::to_string(page_rank.steps) + "\n";
+				if (options.seed && page_rank.seed(pr_checkpoint)) pr_notes += "Seeded from " + pr_checkpoint + "\n";
+				if (options.checkpoint_every > 0) page_rank.enable_checkpoint(pr_checkpoint, options.checkpoint_every);
+				if (options.pagerank_solver == "push")
+					page_rank.compute_push(default_workers(), options.push_tolerance);
+				else if (options.pagerank_solver == "lumped" || options.pagerank_solver == "scc")
+					page_rank.compute_reduced(options.pagerank_solver == "scc");
+				else if (options.blockrank)
+					page_rank.compute_blockrank(options.blockrank_size, options.blockrank_hosts, default_workers(), options.blockrank_compare);
+				else if (options.workers > 0)
+					page_rank.compute_partitioned(options.workers);
+				else
+					page_rank.compute();
+				pr_result = CachedResult{page_rank.get_stats(), page_rank.steps, page_rank.elapsed.count(), {page_rank.get_scores()}};
+				page_rank.free_T_matrix_memory();
+				cache.store(pr_key, pr_result);
+			}, options.concurrent ? std::vector<unsigned int>() : std::vector<unsigned int>{in_task});
+
+			// HITS
+			hits_task = tasks.add("hits", [&]() {
+				if (hits_loaded) return;
+				HITS hits = HITS(top_k,ds_path);
+				std::string hits_checkpoint = options.checkpoint_dir + "/" + ds + ".hits.ckpt";
+				if (options.resume && hits.resume(hits_checkpoint)) hits_notes += "Resumed at step " + std::to_string(hits.steps) + "\n";
+				if (options.seed && hits.seed(hits_checkpoint)) hits_notes += "Seeded from " + hits_checkpoint + "\n";
+				if (options.checkpoint_every > 0) hits.enable_checkpoint(hits_checkpoint, options.checkpoint_every);
+				std::string stats;
+				if (options.hits_solver == "lanczos") {
+					hits.compute_lanczos(options.hits_rank, options.hits_subspace);
+					stats = hits.get_stats() + hits.get_singular_values_str();
+				} else {
+					if (options.workers > 0)
+						hits.compute_partitioned(options.workers);
+					else
+						hits.compute();
+					stats = hits.get_stats();
+				}
+				hits_result = CachedResult{stats, hits.steps, hits.elapsed.count(), {hits.get_authority_scores(), hits.get_hub_scores()}};
+				hits.free_matrices_memory();
+				cache.store(hits_key, hits_result);
+			}, options.concurrent ? std::vector<unsigned int>() : std::vector<unsigned int>{pr_task});
+		}
+
+		// top-k rankings and Jaccard Coefficient
+		unsigned int in_topk_task = tasks.add("indegree top-k", [&]() { select_topk(in_result.scores[0], top_k, IN_topk); }, {in_task});
+		unsigned int pr_topk_task = tasks.add("pagerank top-k", [&]() { select_topk(pr_result.scores[0], top_k, PR_topk); }, {pr_task});
+		unsigned int authority_topk_task = tasks.add("authority top-k", [&]() { select_topk(hits_result.scores[0], top_k, authority_topk); }, {hits_task});
+		unsigned int hub_topk_task = tasks.add("hub top-k", [&]() { select_topk(hits_result.scores[1], top_k, hub_topk); }, {hits_task});
+		tasks.add("jaccard", [&]() {
+			jaccard = std::make_unique<JaccardCoefficient>(top_k, IN_topk, PR_topk, authority_topk, hub_topk);
+			jaccard->obtain_results();
+		}, {in_topk_task, pr_topk_task, authority_topk_task, hub_topk_task});
+
+		tasks.run();
+
+		// printing the results in the usual order
+		if (fused_run) reporter.print("FUSED\n" + fused_stats + "\n");
+
+		reporter.print("IN_DEGREE\n");
+		if (in_loaded) reporter.print(loaded_note(in_load));
+		reporter.print(in_result.stats);
+		if(verbose) reporter.print_topk(std::move(IN_topk), "In Degree");
+		reporter.save_rank(result_dir + ds + ".indegree.rank", in_result.scores[0]);
+		reporter.print("\n");
+
+		reporter.print("PAGE_RANK\n");
+		if (pr_loaded) reporter.print(loaded_note(pr_load));
+		reporter.print(pr_notes + pr_result.stats);
+		if(verbose) reporter.print_topk(std::move(PR_topk), "PageRank Prestige");
+		reporter.save_rank(result_dir + ds + ".pagerank.rank", pr_result.scores[0]);
+		reporter.print("\n");
+
+		reporter.print("HITS\n");
+		if (hits_loaded) reporter.print(loaded_note(hits_load));
+		reporter.print(hits_notes + hits_result.stats);
 		if(verbose) {
-			std::cout << std::endl;
-			hits.print_topk_hub();
-			std::cout << std::endl;
-			hits.print_topk_authority();
+			reporter.print("\nHub scores\n");
+			reporter.print_topk(std::move(hub_topk), "Hub");
+			reporter.print("\nAuthority scores\n");
+			reporter.print_topk(std::move(authority_topk), "Authority");
 		}
-		hits.free_matrices_memory();
-		std::cout << std::endl;
+		reporter.save_rank(result_dir + ds + ".authority.rank", hits_result.scores[0]);
+		reporter.save_rank(result_dir + ds + ".hub.rank", hits_result.scores[1]);
+		reporter.print("\n");
+
+		if(verbose) reporter.print(jaccard->format_results());
+		if (options.concurrent) reporter.print("TASKS\n" + tasks.timeline() + "\n");
 
-		// Jaccard Coefficient
-		JaccardCoefficient jaccard = JaccardCoefficient(top_k, in_degree.IN_topk, page_rank.PR_topk, hits.authority_topk, hits.hub_topk);
-		jaccard.obtain_results();
-		if(verbose) jaccard.print_results();
+		jaccard->save_results(stream_jaccard, ds);
+    	stream_steps << ds << "," << pr_result.steps << "," << hits_result.steps <<"\n";
+    	stream_elapsed << ds << "," << pr_result.elapsed_ms << "," << hits_result.elapsed_ms << "," << in_result.elapsed_ms <<"\n";
 
-		jaccard.save_results(stream_jaccard, ds);
-    	stream_steps << ds << "," << page_rank.steps << "," << hits.steps <<"\n";
-    	stream_elapsed << ds << "," << page_rank.elapsed.count() << "," << hits.elapsed.count() << "," << in_degree.elapsed.count() <<"\n";
+		reporter.print("-------------------" + ds + "---------------------\n\n");
 
-		std::cout << "-------------------" << ds << "---------------------" << std::endl << std::endl;
+		// a failed listing or rank file of this dataset is reported before the next one
+		reporter.wait();
 	}
 
+	reporter.stop();
+
     stream_jaccard.close();
     stream_elapsed.close();
     stream_steps.close();
 
+	if (cache.enabled())
+		std::cout << "Result cache: " << cache.hits << " results loaded, " << cache.misses << " computed" << std::endl;
+
 	return 0;
-}
\ No newline at end of file
+}
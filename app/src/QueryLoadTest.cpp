@@ -0,0 +1,118 @@
+#include "../includes/Utils.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+// Function that connects to the query service.
+int connect_service(const std::string& socket_path) {
+	int client = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+	if (client < 0 || connect(client, (sockaddr*)&address, sizeof(address)) != 0)
+		throw std::runtime_error("Could not connect to " + socket_path);
+	return client;
+}
+
+// Function that sends a batch of queries and waits for one response line for each of them.
+std::string round_trip(int client, const std::string& batch, unsigned int queries) {
+	size_t written = 0;
+	while (written < batch.size()) {
+		ssize_t w = write(client, batch.data() + written, batch.size() - written);
+		if (w <= 0) throw std::runtime_error("Write failed\n");
+		written += w;
+	}
+
+	std::string response;
+	char chunk[1 << 16];
+	unsigned int lines = 0;
+	while (lines < queries) {
+		ssize_t n = read(client, chunk, sizeof(chunk));
+		if (n <= 0) throw std::runtime_error("Connection closed\n");
+		lines += std::count(chunk, chunk + n, '\n');
+		response.append(chunk, n);
+	}
+	return response;
+}
+
+// Function that returns the given percentile of a sorted vector.
+double percentile(const std::vector<double>& sorted, double p) {
+	return sorted[std::min<size_t>(sorted.size() - 1, p * sorted.size())];
+}
+
+int main(int argc, char* argv[]) {
+	const char* usage = "Usage: ./query_load_test <socket> [queries = 100000] [batch = 1], queries and batch at least 1\n";
+	if (argc < 2) {
+		std::cerr << usage;
+		return 1;
+	}
+
+	// a batch of 0 queries would never end the test and 0 queries leave no latencies to report
+	long long queries_arg = argc > 2 ? std::atoll(argv[2]) : 100000;
+	long long batch_arg = argc > 3 ? std::atoll(argv[3]) : 1;
+	if (queries_arg <= 0 || batch_arg <= 0 || queries_arg > UINT32_MAX || batch_arg > UINT32_MAX) {
+		std::cerr << usage;
+		return 1;
+	}
+
+	std::string socket_path = argv[1];
+	unsigned int queries = queries_arg;
+	unsigned int batch_size = batch_arg;
+
+	int client = connect_service(socket_path);
+
+	// sampling real node IDs from the PageRank ranking, so that RANK queries hit the position table
+	std::vector<unsigned long> nodes;
+	std::string sample = round_trip(client, "TOPK pagerank 100000\n", 1);
+	if (sample.rfind("OK", 0) != 0) throw std::runtime_error("Unexpected response: " + sample);
+	std::istringstream sample_stream(sample.substr(2));
+	std::string item;
+	while (sample_stream >> item) nodes.push_back(std::stoul(item.substr(0, item.find(':'))));
+
+	const std::vector<std::string> algorithms = {"indegree", "pagerank", "authority", "hub"};
+	std::mt19937 rng(42);
+	auto pick = [&](size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(rng); };
+
+	// mix of queries: 60% RANK, 30% TOPK with k <= 100, 10% JACCARD with k <= 1024
+	auto make_query = [&]() {
+		unsigned int kind = pick(10);
+		if (kind < 6)
+			return "RANK " + algorithms[pick(4)] + " " + std::to_string(nodes[pick(nodes.size())]) + "\n";
+		if (kind < 9)
+			return "TOPK " + algorithms[pick(4)] + " " + std::to_string(1 + pick(100)) + "\n";
+		return "JACCARD " + algorithms[pick(4)] + " " + algorithms[pick(4)] + " " + std::to_string(1 << pick(11)) + "\n";
+	};
+
+	std::vector<double> latencies;
+	latencies.reserve(queries / batch_size + 1);
+	unsigned int errors = 0, misses = 0;
+
+	auto start = now();
+	for (unsigned int sent = 0; sent < queries; sent += batch_size) {
+		unsigned int n = std::min(batch_size, queries - sent);
+		std::string batch;
+		for (unsigned int i = 0; i < n; i++) batch += make_query();
+
+		auto batch_start = now();
+		std::string response = round_trip(client, batch, n);
+		latencies.push_back(Duration(now() - batch_start).count() * 1000.);
+
+		// nodes without in-links are not in the InDegree ranking, they are counted apart
+		for (size_t pos = response.find("ERR"); pos != std::string::npos; pos = response.find("ERR", pos + 1))
+			response.compare(pos, 19, "ERR node not ranked") == 0 ? misses++ : errors++;
+	}
+	Duration elapsed = now() - start;
+	close(client);
+
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << "Queries: " << queries << " \t Batch: " << batch_size << " \t Errors: " << errors << " \t Not ranked: " << misses << std::endl;
+	std::cout << "Throughput: " << queries / (elapsed.count() / 1000.) << " queries/s" << std::endl;
+	std::cout << "Batch latency p50: " << percentile(latencies, 0.50) << " us \t p99: " << percentile(latencies, 0.99)
+			  << " us \t max: " << latencies.back() << " us" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "../includes/RankStore.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <csignal>
+
+// Function that executes all the complete lines of a buffer and removes them, the responses are appended to out.
+void execute_lines(const RankStore& store, std::string& buffer, std::string& out) {
+	size_t begin = 0, end;
+	while ((end = buffer.find('\n', begin)) != std::string::npos) {
+		if (end > begin) out += store.execute(buffer.substr(begin, end - begin));
+		begin = end + 1;
+	}
+	buffer.erase(0, begin);
+}
+
+// Function that serves a client connected to the socket; all the queries received with a single read are answered with a single write.
+void serve_client(const RankStore& store, int client) {
+	std::string buffer, out;
+	char chunk[1 << 16];
+	ssize_t n;
+
+	while ((n = read(client, chunk, sizeof(chunk))) > 0) {
+		buffer.append(chunk, n);
+		out.clear();
+		execute_lines(store, buffer, out);
+
+		size_t written = 0;
+		while (written < out.size()) {
+			ssize_t w = write(client, out.data() + written, out.size() - written);
+			if (w <= 0) {
+				close(client);
+				return;
+			}
+			written += w;
+		}
+	}
+	close(client);
+}
+
+// Function that listens on a Unix domain socket, each client is served by its own thread.
+void serve_socket(const RankStore& store, const std::string& socket_path) {
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0)
+		throw std::runtime_error("Could not create the socket");
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path))
+		throw std::invalid_argument("Socket path too long");
+	std::strcpy(address.sun_path, socket_path.c_str());
+
+	unlink(socket_path.c_str());
+	if (bind(server, (sockaddr*)&address, sizeof(address)) != 0 || listen(server, 64) != 0)
+		throw std::runtime_error("Could not listen on " + socket_path);
+
+	std::cerr << "Listening on " << socket_path << std::endl;
+
+	while (true) {
+		int client = accept(server, NULL, NULL);
+		if (client < 0) continue;
+		std::thread(serve_client, std::cref(store), client).detach();
+	}
+}
+
+// Function that answers the queries read from the standard input, the responses are flushed when no more input is buffered.
+void serve_stdin(const RankStore& store) {
+	std::string line, out;
+	while (std::getline(std::cin, line)) {
+		if (!line.empty()) out += store.execute(line);
+		if (std::cin.rdbuf()->in_avail() <= 0) {
+			write_all(stdout, out);
+			std::fflush(stdout);
+			out.clear();
+		}
+	}
+	write_all(stdout, out);
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 3 && !(argc == 5 && std::string(argv[3]) == "--socket")) {
+		std::cerr << "Usage: ./query_service <result_dir> <dataset> [--socket <path>]\n"
+				  << "Queries, one per line:\n"
+				  << "  TOPK <algo> <k>\n"
+				  << "  RANK <algo> <node>\n"
+				  << "  JACCARD <algo1> <algo2> <k>\n"
+				  << "with <algo> in indegree, pagerank, authority, hub.\n";
+		return 1;
+	}
+
+	// a client that disconnects while we are writing must not kill the service
+	std::signal(SIGPIPE, SIG_IGN);
+
+	RankStore store(argv[1], argv[2]);
+
+	if (argc == 5)
+		serve_socket(store, argv[4]);
+	else
+		serve_stdin(store);
+
+	return 0;
+}